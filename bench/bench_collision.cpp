@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include "../include/hashmap.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "./scenes.hpp"
+
+using namespace YAAACD;
+using namespace YAAACD::bench;
+
+/* COLLISION BENCHMARKS
+ * Construction and queries are timed separately for each engine, on every
+ * scene, for hit and miss cases from 1k to 10M triangles per mesh (the
+ * brute force stops at 10k). Throughput is reported as triangles per
+ * second (items_per_second); `cmake --build . --target run_benchmarks`
+ * writes all results to benchmarks.json.
+ */
+
+static const std::vector<int64_t> SIZES = {
+    1'000,
+    10'000,
+    100'000,
+    1'000'000,
+    10'000'000
+};
+static const std::vector<int64_t> BRUTEFORCE_SIZES = {1'000, 10'000};
+static const std::vector<int64_t> OUTCOMES = {0, 1};  // miss, hit
+
+/**
+ * @brief Return a scene, reusing the last one generated when it matches.
+ * Benchmarks sharing arguments run back to back, so this avoids most of the
+ * regeneration without keeping large scenes alive.
+ */
+static const Scene& scene(SceneKind kind, size_t triangles, bool hit) {
+    static std::tuple<SceneKind, size_t, bool> key;
+    static Scene cached;
+
+    if (!cached.first || key != std::make_tuple(kind, triangles, hit)) {
+        cached = Scene();
+        cached = make_scene(kind, triangles, hit);
+        key = {kind, triangles, hit};
+    }
+
+    return cached;
+}
+
+/**
+ * @brief Subdivision depth giving grid cells about as large as the
+ * triangles of a mesh of the given size.
+ */
+static int hash_levels(size_t triangles) {
+    return std::max(1, static_cast<int>(std::log2(std::cbrt(triangles))));
+}
+
+static void report(benchmark::State& state, size_t triangles) {
+    state.counters["triangles"] = triangles;
+    state.SetItemsProcessed(state.iterations() * triangles);
+}
+
+static void check(benchmark::State& state, bool collides) {
+    if (collides != static_cast<bool>(state.range(1)))
+        state.SkipWithError("the scene does not have the expected outcome");
+}
+
+static void BM_BruteforceQuery(benchmark::State& state, SceneKind kind) {
+    const Scene& pair = scene(kind, state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        const bool collides = bruteforce_collides(*pair.first, *pair.second);
+        benchmark::DoNotOptimize(collides);
+    }
+
+    report(state, pair.triangles());
+}
+
+static void BM_OctreeBuild(benchmark::State& state, SceneKind kind) {
+    const Scene& pair = scene(kind, state.range(0), state.range(1));
+
+    for (auto _ : state) {
+        Octree tree(pair.first);
+        benchmark::DoNotOptimize(tree.build().nodes);
+    }
+
+    report(state, pair.first->size());
+}
+
+static void BM_OctreeQuery(benchmark::State& state, SceneKind kind) {
+    const Scene& pair = scene(kind, state.range(0), state.range(1));
+    Octree tree1(pair.first);
+    Octree tree2(pair.second);
+    check(state, tree1.collides(&tree2));
+
+    for (auto _ : state) benchmark::DoNotOptimize(tree1.collides(&tree2));
+
+    report(state, pair.triangles());
+}
+
+static void BM_SpatialHashMapBuild(benchmark::State& state, SceneKind kind) {
+    const Scene& pair = scene(kind, state.range(0), state.range(1));
+    const int levels = hash_levels(pair.first->size());
+
+    for (auto _ : state) {
+        SpatialHashMap map(pair.first, levels);
+        benchmark::DoNotOptimize(map.cell_count());
+    }
+
+    report(state, pair.first->size());
+}
+
+static void BM_SpatialHashMapQuery(benchmark::State& state, SceneKind kind) {
+    const Scene& pair = scene(kind, state.range(0), state.range(1));
+    const SpatialHashMap map(pair.first, hash_levels(pair.first->size()));
+    check(state, map.collides(*pair.second));
+
+    for (auto _ : state) benchmark::DoNotOptimize(map.collides(*pair.second));
+
+    report(state, pair.triangles());
+}
+
+#define YAAACD_SCENE_BENCHMARKS(name, kind)                                 \
+    BENCHMARK_CAPTURE(BM_BruteforceQuery, name, kind)                       \
+        ->ArgsProduct({BRUTEFORCE_SIZES, OUTCOMES})                         \
+        ->Unit(benchmark::kMillisecond);                                    \
+    BENCHMARK_CAPTURE(BM_OctreeBuild, name, kind)                           \
+        ->ArgsProduct({SIZES, {0}})                                         \
+        ->Unit(benchmark::kMillisecond);                                    \
+    BENCHMARK_CAPTURE(BM_OctreeQuery, name, kind)                           \
+        ->ArgsProduct({SIZES, OUTCOMES})                                    \
+        ->Unit(benchmark::kMillisecond);                                    \
+    BENCHMARK_CAPTURE(BM_SpatialHashMapBuild, name, kind)                   \
+        ->ArgsProduct({SIZES, {0}})                                         \
+        ->Unit(benchmark::kMillisecond);                                    \
+    BENCHMARK_CAPTURE(BM_SpatialHashMapQuery, name, kind)                   \
+        ->ArgsProduct({SIZES, OUTCOMES})                                    \
+        ->Unit(benchmark::kMillisecond)
+
+YAAACD_SCENE_BENCHMARKS(spheres, SceneKind::SPHERES);
+YAAACD_SCENE_BENCHMARKS(terrain, SceneKind::TERRAIN);
+YAAACD_SCENE_BENCHMARKS(combs, SceneKind::COMBS);
+YAAACD_SCENE_BENCHMARKS(stacks, SceneKind::STACKS);
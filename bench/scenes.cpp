@@ -0,0 +1,238 @@
+#include "./scenes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "../include/mesh.hpp"
+
+using namespace YAAACD;
+using namespace YAAACD::bench;
+
+// Sheets of a stack and teeth of a comb, split evenly between both meshes.
+constexpr size_t STACK_SHEETS = 16;
+constexpr size_t COMB_TEETH = 16;
+
+/**
+ * @brief Append a welded grid of (columns + 1) x (rows + 1) vertices and
+ * 2 x columns x rows triangles to a mesh.
+ *
+ * @param mesh mesh to extend
+ * @param columns number of cells along a row
+ * @param rows number of rows of cells
+ * @param position callable mapping (column, row) to a vertex
+ */
+template <typename Position>
+static void add_grid(
+    IndexedMesh& mesh,
+    size_t columns,
+    size_t rows,
+    Position position
+) {
+    const uint32_t base = mesh.vertices.size();
+
+    for (size_t row = 0; row <= rows; row++)
+        for (size_t column = 0; column <= columns; column++)
+            mesh.vertices.push_back(position(column, row));
+
+    for (size_t row = 0; row < rows; row++)
+        for (size_t column = 0; column < columns; column++) {
+            const uint32_t a = base + row * (columns + 1) + column;
+            const uint32_t b = a + columns + 1;
+            mesh.faces.push_back({a, a + 1, b});
+            mesh.faces.push_back({a + 1, b + 1, b});
+        }
+}
+
+/**
+ * @brief Side of a square grid with about the given number of triangles.
+ */
+static size_t grid_side(size_t triangles) {
+    return std::max<size_t>(
+        2,
+        static_cast<size_t>(std::sqrt(triangles / 2.0)) & ~size_t(1)
+    );
+}
+
+/**
+ * @brief Geodesic sphere: every face of an icosahedron is split into
+ * frequency^2 triangles whose vertices are pushed onto the sphere.
+ */
+static IndexedMesh sphere(
+    size_t triangles,
+    const Vertex& center,
+    double radius
+) {
+    const double phi = (1 + std::sqrt(5.0)) / 2;
+    const std::array<Vertex, 12> corners = {
+        Vertex(-1, phi, 0), Vertex(1, phi, 0),  Vertex(-1, -phi, 0),
+        Vertex(1, -phi, 0), Vertex(0, -1, phi), Vertex(0, 1, phi),
+        Vertex(0, -1, -phi), Vertex(0, 1, -phi), Vertex(phi, 0, -1),
+        Vertex(phi, 0, 1),  Vertex(-phi, 0, -1), Vertex(-phi, 0, 1)
+    };
+    const std::array<Face, 20> icosahedron = {{
+        {0, 11, 5}, {0, 5, 1},  {0, 1, 7},   {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9},  {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4},  {3, 4, 2},  {3, 2, 6},   {3, 6, 8},  {3, 8, 9},
+        {4, 9, 5},  {2, 4, 11}, {6, 2, 10},  {8, 6, 7},  {9, 8, 1}
+    }};
+    const size_t frequency =
+        std::max<size_t>(1, std::lround(std::sqrt(triangles / 20.0)));
+
+    IndexedMesh mesh;
+    for (const Face& face : icosahedron) {
+        const Vertex& a = corners[face[0]];
+        const Vertex& b = corners[face[1]];
+        const Vertex& c = corners[face[2]];
+        const uint32_t base = mesh.vertices.size();
+
+        // Vertex (i, j) is a + i / frequency (b - a) + j / frequency (c - a);
+        // row i holds frequency + 1 - i vertices.
+        for (size_t i = 0; i <= frequency; i++)
+            for (size_t j = 0; i + j <= frequency; j++) {
+                const double s = double(i) / frequency;
+                const double t = double(j) / frequency;
+                const double x = a.x + s * (b.x - a.x) + t * (c.x - a.x);
+                const double y = a.y + s * (b.y - a.y) + t * (c.y - a.y);
+                const double z = a.z + s * (b.z - a.z) + t * (c.z - a.z);
+                const double scale = radius / std::sqrt(x * x + y * y + z * z);
+
+                mesh.vertices.emplace_back(
+                    center.x + scale * x,
+                    center.y + scale * y,
+                    center.z + scale * z
+                );
+            }
+
+        auto index = [base, frequency](size_t i, size_t j) -> uint32_t {
+            // Rows before i hold sum over k < i of (frequency + 1 - k).
+            return base + i * (frequency + 1) - i * (i - 1) / 2 + j;
+        };
+        for (size_t i = 0; i < frequency; i++)
+            for (size_t j = 0; i + j < frequency; j++) {
+                mesh.faces.push_back(
+                    {index(i, j), index(i + 1, j), index(i, j + 1)}
+                );
+                if (i + j + 1 < frequency)
+                    mesh.faces.push_back(
+                        {index(i + 1, j), index(i + 1, j + 1), index(i, j + 1)}
+                    );
+            }
+    }
+
+    return mesh;
+}
+
+/**
+ * @brief Noisy height field over [0, 10]^2.
+ */
+static IndexedMesh terrain(size_t triangles, double offset, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> noise(-0.02, 0.02);
+    const size_t side = grid_side(triangles);
+
+    IndexedMesh mesh;
+    add_grid(mesh, side, side, [&](size_t column, size_t row) {
+        const double x = 10.0 * column / side;
+        const double y = 10.0 * row / side;
+
+        return Vertex(
+            x,
+            y,
+            offset + 0.3 * std::sin(0.7 * x + seed) * std::cos(0.5 * y) +
+                noise(generator)
+        );
+    });
+
+    return mesh;
+}
+
+/**
+ * @brief Comb of thin vertical plates, one every 2 units along x starting
+ * at `start`; the tooth `tilted` leans by 1.5 units towards +x.
+ */
+static IndexedMesh comb(size_t triangles, double start, size_t tilted) {
+    const size_t side = grid_side(triangles / COMB_TEETH);
+
+    IndexedMesh mesh;
+    for (size_t tooth = 0; tooth < COMB_TEETH; tooth++) {
+        const double x = start + 2.0 * tooth;
+        const double lean = tooth == tilted ? 1.5 : 0;
+
+        add_grid(mesh, side, side, [&](size_t column, size_t row) {
+            const double height = double(row) / side;
+            return Vertex(x + lean * height, 10.0 * column / side, 4 * height);
+        });
+    }
+
+    return mesh;
+}
+
+/**
+ * @brief Every other sheet of a stack of wavy sheets 0.1 apart, starting
+ * with sheet `first`; the sheet `spiked` has its central vertex raised
+ * through the sheet above.
+ */
+static IndexedMesh stack(size_t triangles, size_t first, size_t spiked) {
+    const size_t side = grid_side(triangles / (STACK_SHEETS / 2));
+
+    IndexedMesh mesh;
+    for (size_t sheet = first; sheet < STACK_SHEETS; sheet += 2)
+        add_grid(mesh, side, side, [&](size_t column, size_t row) {
+            const double x = 10.0 * column / side;
+            const double y = 10.0 * row / side;
+            const bool spike =
+                sheet == spiked && column == side / 2 && row == side / 2;
+
+            return Vertex(
+                x,
+                y,
+                0.1 * sheet + 0.02 * std::sin(x + y) + (spike ? 0.15 : 0)
+            );
+        });
+
+    return mesh;
+}
+
+/**
+ * @brief Generate a pair of meshes.
+ *
+ * @param kind shape of the meshes
+ * @param triangles approximate number of triangles of each mesh
+ * @param hit whether the meshes intersect
+ * @return Scene generated meshes
+ */
+Scene YAAACD::bench::make_scene(SceneKind kind, size_t triangles, bool hit) {
+    constexpr size_t NONE = STACK_SHEETS;
+    IndexedMesh first, second;
+
+    switch (kind) {
+        case SceneKind::SPHERES:
+            first = sphere(triangles, Vertex(0, 0, 0), 1);
+            second = hit ? sphere(triangles, Vertex(1, 0, 0), 1)
+                         : sphere(triangles, Vertex(0, 0, 0), 0.5);
+            break;
+        case SceneKind::TERRAIN:
+            first = terrain(triangles, 0, 1);
+            second = hit ? terrain(triangles, 0, 2)
+                         : terrain(triangles, 0.1, 1);
+            break;
+        case SceneKind::COMBS:
+            first = comb(triangles, 0, NONE);
+            second = comb(triangles, 1, hit ? COMB_TEETH / 2 : NONE);
+            break;
+        case SceneKind::STACKS:
+            first = stack(triangles, 0, NONE);
+            second = stack(triangles, 1, hit ? STACK_SHEETS / 2 + 1 : NONE);
+            break;
+    }
+
+    return {
+        std::make_shared<const IndexedMesh>(std::move(first)),
+        std::make_shared<const IndexedMesh>(std::move(second))
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "../include/mesh.hpp"
+
+namespace YAAACD::bench {
+
+/**
+ * @brief Synthetic mesh pairs, each stressing the engines differently.
+ *
+ * SPHERES: two geodesic spheres, overlapping (hit) or one floating inside
+ * the other (miss, with fully overlapping bounds).
+ * TERRAIN: two noisy height fields, crossing (hit) or one lying just above
+ * the other (miss).
+ * COMBS: two combs of thin plates with interleaved teeth, one tooth tilted
+ * into its neighbour (hit) or all parallel (miss).
+ * STACKS: alternating sheets of a stack with small gaps, one sheet spiking
+ * through the next (hit) or none (miss).
+ */
+enum class SceneKind { SPHERES, TERRAIN, COMBS, STACKS };
+
+struct Scene {
+    std::shared_ptr<const IndexedMesh> first;
+    std::shared_ptr<const IndexedMesh> second;
+
+    size_t triangles() const {
+        return this->first->size() + this->second->size();
+    }
+};
+
+Scene make_scene(SceneKind kind, size_t triangles, bool hit);
+
+}  // namespace YAAACD::bench
@@ -8,7 +8,13 @@ class YAAACDConan(ConanFile):
     options = {"shared": [True, False]}
     default_options = "shared=False"
     generators = "cmake"
-    exports_sources = "src/*", "include/*", "CMakeLists.txt", "test/*"
+    exports_sources = (
+        "src/*",
+        "include/*",
+        "CMakeLists.txt",
+        "test/*",
+        "bench/*",
+    )
 
     def _configure_cmake(self):
         cmake = CMake(self)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// Default size of the blocks an arena requests from the system.
+constexpr size_t ARENA_BLOCK_SIZE = 1 << 20;
+
+namespace YAAACD {
+
+/**
+ * @brief Monotonic memory resource made of large blocks.
+ *
+ * Allocation bumps a pointer; deallocation does nothing. reset() rewinds to
+ * the first block in O(1) and keeps every block. A request that does not
+ * fit in the current block takes the first unused block that fits before
+ * asking the system for a new one, so kept blocks of any size are reused
+ * and a structure rebuilt into the same arena with the same requests stops
+ * allocating once the arena has grown to its size. The blocks are returned
+ * to the system when the arena is destroyed. Allocation is thread-safe.
+ */
+class Arena : public std::pmr::memory_resource {
+ private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::vector<Block> _blocks;
+    size_t _block = 0;  // block currently allocated from
+    size_t _offset = 0;  // first free byte of the current block
+    size_t _block_size;
+    mutable std::mutex _mutex;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other
+    ) const noexcept override {
+        return this == &other;
+    }
+
+ public:
+    explicit Arena(size_t block_size = ARENA_BLOCK_SIZE);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void reset();
+    size_t capacity() const;
+};
+
+}  // namespace YAAACD
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "./common.hpp"
+#include "./mesh.hpp"
+#include "./octree.hpp"
+#include "./packs.hpp"
+#include "./partition.hpp"
+
+// Number of bins the centroid range is split into along each axis.
+constexpr int SAH_BINS = 16;
+// Relative costs of visiting a node and of testing one triangle.
+constexpr double SAH_TRAVERSAL_COST = 1.0;
+constexpr double SAH_INTERSECTION_COST = 1.0;
+// Leaves are never larger than this, even if splitting looks more expensive.
+constexpr uint32_t MAX_LEAF_SIZE = 2 * PACK_WIDTH;
+
+namespace YAAACD {
+
+/**
+ * @brief Bounding volume hierarchy built with a binned surface area
+ * heuristic.
+ *
+ * Unlike the octrees, splits follow the distribution of the triangles rather
+ * than the centers of the boxes, which keeps nodes tight on thin or elongated
+ * meshes. Nodes are stored in one array: the two children of an inner node
+ * are adjacent, and leaves reference ranges of a shared triangle index buffer
+ * mirrored as SIMD packs.
+ */
+class Bvh {
+ public:
+    struct Node {
+        AABB bounds;
+        uint32_t first = 0;  // left child (inner node) or first index (leaf)
+        uint32_t count = 0;  // number of triangle indices, 0 for inner nodes
+        uint32_t pack = 0;  // first SIMD pack of the members (leaf only)
+
+        bool is_leaf() const {
+            return this->count != 0;
+        }
+    };
+
+ private:
+    std::shared_ptr<const IndexedMesh> _mesh;
+    std::vector<uint32_t> _indices;
+    std::vector<Node> _nodes;
+    std::vector<TrianglePack> _packs;
+
+    void _build(
+        uint32_t node,
+        const std::vector<AABB>& boxes,
+        uint32_t first,
+        uint32_t count
+    );
+    bool _leaves_intersect(
+        const Node& leaf1,
+        const Bvh& other,
+        const Node& leaf2
+    ) const;
+    bool _leaf_intersects(
+        const Node& leaf,
+        std::span<const TrianglePack> packs
+    ) const;
+
+ public:
+    explicit Bvh(std::shared_ptr<const IndexedMesh> mesh);
+    explicit Bvh(const std::vector<Triangle>& triangles);
+
+    bool collides(const Bvh& other) const;
+    bool collides(OctreeNode* octree) const;
+    double sah_cost() const;
+
+    const std::vector<Node>& nodes() const {
+        return this->_nodes;
+    }
+    const std::vector<uint32_t>& indices() const {
+        return this->_indices;
+    }
+    const IndexedMesh& mesh() const {
+        return *this->_mesh;
+    }
+};
+
+}  // namespace YAAACD
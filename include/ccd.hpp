@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "./common.hpp"
+#include "./distance.hpp"
+#include "./partition.hpp"
+#include "./transform.hpp"
+
+// Slack on the barycentric and edge parameters of a contact found at a root
+// of the coplanarity polynomial, so that contacts on shared edges and
+// vertices are not lost to rounding.
+constexpr double CCD_EPSILON = 1e-9;
+
+namespace YAAACD {
+
+/**
+ * @brief Rigid motion over one time step, from `start` at time 0 to `end`
+ * at time 1.
+ */
+struct Motion {
+    Transform start;
+    Transform end;
+};
+
+/**
+ * @brief Earliest contact found by a continuous collision query, as a
+ * fraction of the time step. `first` indexes the triangles of the queried
+ * object, `second` those of its argument.
+ */
+struct ImpactResult {
+    double time = std::numeric_limits<double>::infinity();
+    uint32_t first = NO_TRIANGLE;
+    uint32_t second = NO_TRIANGLE;
+
+    bool found() const {
+        return this->first != NO_TRIANGLE;
+    }
+};
+
+namespace helpers {
+AABB transformed_box(const BoundingBox& box, const Transform& transform);
+bool sweep_overlap(
+    const AABB& fixed,
+    const AABB& start,
+    const AABB& end,
+    double limit,
+    double& enter
+);
+double triangles_impact(
+    const Triangle& start1,
+    const Triangle& end1,
+    const Triangle& start2,
+    const Triangle& end2,
+    double limit
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
@@ -4,6 +4,7 @@
 #include <CGAL/Point_3.h>
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -34,32 +35,48 @@ class Vertex {
 
 typedef std::array<Vertex, 3> Triangle;
 
+class BoundingBox;
+
+/**
+ * @brief Up to 8 AABBs stored as structure-of-arrays for batched overlap
+ * tests. Lane i holds the i-th box; missing boxes are stored inverted
+ * (lower = +inf, upper = -inf) so they never overlap anything.
+ */
+struct alignas(64) BoxPack {
+    double lower[3][8];
+    double upper[3][8];
+
+    BoxPack();
+    explicit BoxPack(const std::array<const BoundingBox *, 8> &boxes);
+};
+
 class BoundingBox {
  private:
-    std::array<Vertex, 8> _corners;
-    std::array<BoundingBox *, 8> _children = {nullptr};
-    Vertex *_center = nullptr;
-    std::vector<Triangle> _members;  // only for sparial hashing
+    Vertex _lower;
+    Vertex _upper;
     int _level = 0;
     const Boundaries
-    _child_boundaries(int index, const Boundaries &parent_boundaries);
+    _child_boundaries(int index, const Boundaries &parent_boundaries) const;
 
  public:
     bool intersects(const BoundingBox &box) const;
+    uint8_t intersects(const BoxPack &boxes) const;
     bool contains(const Triangle &triangle) const;
     const bool contains(const Vertex &vertex) const;
-    std::array<BoundingBox *, 8> children();
-    const std::array<Vertex, 8> &corners() const;
-    std::vector<BoundingBox *>
-    split(int level, const std::vector<Triangle> &triangles);
-    std::vector<Triangle> &members() {
-        return this->_members;
+    std::array<BoundingBox, 8> children() const;
+    const std::array<Vertex, 8> corners() const;
+    const Vertex &lower() const {
+        return this->_lower;
+    }
+    const Vertex &upper() const {
+        return this->_upper;
     }
 
-    Vertex center();
+    Vertex center() const;
 
     explicit BoundingBox(const std::vector<Vertex> &vertices);
     explicit BoundingBox(const std::array<Vertex, 8> &corners, int level);
+    explicit BoundingBox(const Vertex &lower, const Vertex &upper, int level);
 
     const int level() const {
         return this->_level;
@@ -81,6 +98,13 @@ const CGALKernel::Triangle_3 to_Triangle_3(const Triangle &triangle);
 
 namespace helpers {
 bool primes_intersect(const std::array<const std::vector<Triangle>, 2> &sets);
-}
+bool triangles_intersect(const Triangle &triangle1, const Triangle &triangle2);
+int orientation(
+    const Vertex &a,
+    const Vertex &b,
+    const Vertex &c,
+    const Vertex &d
+);
+}  // namespace helpers
 
 }  // namespace YAAACD
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#include "./common.hpp"
+
+namespace YAAACD {
+
+/**
+ * @brief Pair of intersecting triangles. `first` indexes the triangles of
+ * the object the query is run on, `second` those of its argument.
+ */
+struct Contact {
+    uint32_t first = 0;
+    uint32_t second = 0;
+    bool has_segment = false;  // false if not requested or coplanar
+    Vertex start;  // intersection segment, if has_segment
+    Vertex end;
+};
+
+/**
+ * @brief Receives each contact as it is found; returning false ends the
+ * query.
+ */
+typedef std::function<bool(const Contact&)> ContactCallback;
+
+struct ContactQuery {
+    size_t max_contacts = std::numeric_limits<size_t>::max();
+    bool segments = false;  // compute intersection segments
+};
+
+/**
+ * @brief Forwards contacts to a callback, enforcing the limits of a query.
+ *
+ * Engines report every intersecting pair they find and stop as soon as
+ * report() returns false.
+ */
+class ContactSink {
+ private:
+    const ContactCallback& _callback;
+    ContactQuery _query;
+    size_t _count = 0;
+    bool _stopped;
+
+ public:
+    ContactSink(const ContactCallback& callback, const ContactQuery& query);
+
+    bool report(
+        uint32_t first,
+        uint32_t second,
+        const Triangle& triangle1,
+        const Triangle& triangle2
+    );
+
+    bool stopped() const {
+        return this->_stopped;
+    }
+    size_t count() const {
+        return this->_count;
+    }
+};
+
+namespace helpers {
+bool intersection_segment(
+    const Triangle& triangle1,
+    const Triangle& triangle2,
+    Vertex& start,
+    Vertex& end
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "./common.hpp"
+
+// Triangle id of a distance query that found no pair below its bound.
+constexpr uint32_t NO_TRIANGLE = std::numeric_limits<uint32_t>::max();
+
+namespace YAAACD {
+
+/**
+ * @brief Closest pair of triangles found by a distance query. `first`
+ * indexes the triangles of the queried object, `second` those of its
+ * argument.
+ */
+struct DistanceResult {
+    double distance = std::numeric_limits<double>::infinity();
+    uint32_t first = NO_TRIANGLE;
+    uint32_t second = NO_TRIANGLE;
+    Vertex point1;  // closest point on triangle `first`
+    Vertex point2;  // closest point on triangle `second`
+
+    bool found() const {
+        return this->first != NO_TRIANGLE;
+    }
+};
+
+namespace helpers {
+double box_distance_squared(const BoundingBox& box1, const BoundingBox& box2);
+double triangle_distance_squared(
+    const Triangle& triangle1,
+    const Triangle& triangle2,
+    Vertex& point1,
+    Vertex& point2
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
@@ -1,30 +1,134 @@
 #pragma once
 
 #include <array>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include "./common.hpp"
+#include "./contacts.hpp"
+#include "./mesh.hpp"
 #include "./octree.hpp"
+#include "./partition.hpp"
+#include "./stats.hpp"
 
-constexpr int TABLE_SIZE = 100;
-constexpr int CELL_SIZE = 100;
-constexpr int P1 = 131;
-constexpr int P2 = 97;
-constexpr int P3 = 137;
+// Slot id of an empty slot / result of a failed lookup.
+constexpr uint32_t EMPTY_CELL = std::numeric_limits<uint32_t>::max();
 
 namespace YAAACD {
 
+/**
+ * @brief Integer coordinates of a grid cell.
+ */
+struct Cell {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+
+    friend bool operator==(const Cell& lhs, const Cell& rhs) {
+        return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+    }
+};
+
+/**
+ * @brief Flat open-addressing (linear probing) table mapping cells to dense
+ * ids 0, 1, 2, ... in insertion order.
+ *
+ * Keys are stored in full, so different cells never share an id no matter
+ * how their hashes collide.
+ */
+class CellTable {
+ private:
+    struct Slot {
+        Cell key;
+        uint32_t id = EMPTY_CELL;
+    };
+
+    std::vector<Slot> _slots;
+    uint32_t _size = 0;
+
+    size_t _slot(const Cell& cell) const;
+    void _grow();
+
+ public:
+    explicit CellTable(size_t cells = 0);
+
+    uint32_t insert(const Cell& cell);
+    uint32_t find(const Cell& cell) const;
+
+    size_t size() const {
+        return this->_size;
+    }
+    size_t capacity() const {
+        return this->_slots.size();
+    }
+};
+
+/**
+ * @brief Uniform grid over world space, stored sparsely.
+ *
+ * Every triangle is registered in all cells its AABB overlaps, in a single
+ * pass over the triangles; queries walk the cells of each query triangle the
+ * same way, so no boxes are ever built. Cells are found through a CellTable
+ * and their triangles are stored as contiguous ranges of one index buffer
+ * (CSR layout): cell i owns [offsets[i], offsets[i + 1]).
+ */
 class SpatialHashMap {
  private:
-    int _levels;
-    std::map<int, std::vector<Triangle>> _map;
-    int _hash(BoundingBox* box);
-    void insert(BoundingBox* box);
+    double _cell_size;
+    CellTable _table;
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _indices;
+    std::shared_ptr<const IndexedMesh> _mesh;
+    std::vector<AABB> _bounds;
+    // Bounds of the stored mesh and the range of cells it occupies.
+    AABB _extent;
+    Cell _lower;
+    Cell _upper;
+
+    Cell _cell(const Vertex& vertex) const;
+    template <typename Visitor, typename Stats = NoStats>
+    bool _visit(
+        const Triangle& triangle,
+        Visitor visit,
+        Stats stats = Stats()
+    ) const;
+    template <typename Stats>
+    bool _collides(const Triangle& triangle, Stats stats) const;
 
  public:
-    explicit SpatialHashMap(const std::vector<Triangle>& triangles, int levels);
-    bool collides(const std::vector<Triangle>& triangles);
+    explicit SpatialHashMap(
+        std::shared_ptr<const IndexedMesh> mesh,
+        int levels,
+        double cell_size = 0,
+        size_t table_size = 0
+    );
+    explicit SpatialHashMap(
+        const std::vector<Triangle>& triangles,
+        int levels,
+        double cell_size = 0,
+        size_t table_size = 0
+    );
+    bool collides(const IndexedMesh& mesh) const;
+    bool collides(const IndexedMesh& mesh, QueryStats& stats) const;
+    bool collides(const std::vector<Triangle>& triangles) const;
+    size_t contacts(
+        const IndexedMesh& mesh,
+        const ContactCallback& callback,
+        const ContactQuery& query = ContactQuery()
+    ) const;
+
+    double cell_size() const {
+        return this->_cell_size;
+    }
+    size_t cell_count() const {
+        return this->_table.size();
+    }
+    size_t table_size() const {
+        return this->_table.capacity();
+    }
 };
 
 }  // namespace YAAACD
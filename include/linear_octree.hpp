@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "./common.hpp"
+#include "./mesh.hpp"
+#include "./packs.hpp"
+#include "./partition.hpp"
+
+namespace YAAACD {
+
+/**
+ * @brief Pointer-free octree stored as a single contiguous node array.
+ *
+ * The children of a node are stored next to each other in Morton (octant)
+ * order and child blocks are laid out depth-first, so every subtree occupies a
+ * compact region of the array. Leaves reference ranges of one shared triangle
+ * index buffer, partitioned in place while building, and the same ranges are
+ * mirrored as SIMD packs for the leaf-leaf tests.
+ */
+class LinearOctree {
+ public:
+    struct Node {
+        Vertex lower;
+        Vertex upper;
+        uint32_t first = 0;  // first child (inner node) or first index (leaf)
+        uint32_t count = 0;  // number of triangle indices (leaf only)
+        uint32_t pack = 0;  // first SIMD pack of the members (leaf only)
+        uint8_t children = 0;  // octant mask of the present children
+
+        bool is_leaf() const {
+            return this->children == 0;
+        }
+    };
+
+ private:
+    std::shared_ptr<const IndexedMesh> _mesh;
+    std::vector<uint32_t> _indices;
+    std::vector<Node> _nodes;
+    std::vector<TrianglePack> _packs;
+
+    void _build(
+        uint32_t node,
+        const std::vector<AABB>& boxes,
+        uint32_t first,
+        uint32_t count,
+        int level
+    );
+    bool _leaves_intersect(
+        const Node& leaf1,
+        const LinearOctree& other,
+        const Node& leaf2
+    ) const;
+
+ public:
+    explicit LinearOctree(std::shared_ptr<const IndexedMesh> mesh);
+    explicit LinearOctree(const std::vector<Triangle>& triangles);
+
+    bool collides(const LinearOctree& other) const;
+
+    const std::vector<Node>& nodes() const {
+        return this->_nodes;
+    }
+    const std::vector<uint32_t>& indices() const {
+        return this->_indices;
+    }
+    const IndexedMesh& mesh() const {
+        return *this->_mesh;
+    }
+    const std::vector<TrianglePack>& packs() const {
+        return this->_packs;
+    }
+};
+
+}  // namespace YAAACD
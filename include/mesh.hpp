@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./common.hpp"
+#include "./contacts.hpp"
+#include "./partition.hpp"
+
+namespace YAAACD {
+
+typedef std::array<uint32_t, 3> Face;
+
+/**
+ * @brief Triangle mesh stored as one shared vertex buffer and one index
+ * triple per triangle.
+ *
+ * This is the input format of every engine. Triangles are identified by
+ * their position in `faces`; `bounds` optionally holds one precomputed AABB
+ * per triangle, which engines use instead of computing their own.
+ */
+struct IndexedMesh {
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    std::vector<AABB> bounds;
+
+    IndexedMesh() {}
+    IndexedMesh(std::vector<Vertex> vertices, std::vector<Face> faces);
+    explicit IndexedMesh(const std::vector<Triangle>& triangles);
+
+    size_t size() const {
+        return this->faces.size();
+    }
+    Triangle triangle(uint32_t index) const {
+        const Face& face = this->faces[index];
+
+        return {
+            this->vertices[face[0]],
+            this->vertices[face[1]],
+            this->vertices[face[2]]
+        };
+    }
+
+    std::vector<Triangle> triangles() const;
+    void compute_bounds();
+};
+
+std::vector<AABB> triangle_bounds(const IndexedMesh& mesh);
+bool bruteforce_collides(const IndexedMesh& mesh1, const IndexedMesh& mesh2);
+size_t bruteforce_contacts(
+    const IndexedMesh& mesh1,
+    const IndexedMesh& mesh2,
+    const ContactCallback& callback,
+    const ContactQuery& query = ContactQuery()
+);
+
+}  // namespace YAAACD
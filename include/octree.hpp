@@ -1,36 +1,454 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <span>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include "./arena.hpp"
+#include "./ccd.hpp"
 #include "./common.hpp"
+#include "./contacts.hpp"
+#include "./distance.hpp"
+#include "./mesh.hpp"
+#include "./packs.hpp"
+#include "./partition.hpp"
+#include "./policy.hpp"
+#include "./ray.hpp"
+#include "./scheduler.hpp"
+#include "./stats.hpp"
+#include "./trace.hpp"
+#include "./transform.hpp"
+
+// A subtree is rebuilt by refit() once the sum of its box extents grew past
+// this factor of what it was when the subtree was built.
+constexpr double REFIT_THRESHOLD = 1.5;
+
+// Subtrees with at least this many members are built as separate tasks.
+constexpr uint32_t PARALLEL_GRAIN = 2048;
 
 namespace YAAACD {
 
-class Octree {
+/**
+ * @brief Summary of one octree build.
+ */
+struct BuildStats {
+    size_t triangles = 0;
+    size_t nodes = 0;
+    size_t leaves = 0;
+    double seconds = 0;
+
+    double triangles_per_second() const {
+        return this->seconds > 0 ? this->triangles / this->seconds : 0;
+    }
+};
+
+/**
+ * @brief Summary of one octree refit.
+ */
+struct RefitStats {
+    size_t nodes = 0;  // nodes of the updated tree
+    size_t rebuilt_triangles = 0;  // members of the rebuilt subtrees
+    bool full_rebuild = false;
+    double seconds = 0;
+};
+
+class OctreeNode;
+
+/**
+ * @brief Node pairs where the last query between two octrees stopped,
+ * reused as the starting point of the next query between them.
+ *
+ * The front is a cut through the tree of node pairs visited by the
+ * traversal: separated pairs and leaf pairs, each remembering the pair that
+ * was split to reach it. A query restarts from the front, refines pairs
+ * that started to overlap and merges sibling pairs that all separated back
+ * into their parent. The front is tied to the two trees it was computed
+ * for and starts over from their roots after a rebuild.
+ */
+class CollisionFront {
+ private:
+    friend class OctreeNode;
+
+    enum State : uint8_t { UNTESTED, SEPARATED, DISJOINT, INTERSECTING };
+
+    struct Pair {
+        OctreeNode* first;
+        OctreeNode* second;
+        uint32_t parent;  // split this pair comes from
+        State state;
+        bool fresh;  // tested by the last query
+    };
+    struct Split {
+        OctreeNode* first;
+        OctreeNode* second;
+        uint32_t parent;
+        uint32_t children;  // number of pairs the split produced
+        uint32_t separated = 0;  // scratch for _coarsen()
+        bool touched = false;  // scratch for _coarsen()
+    };
+
+    std::vector<Pair> _pairs;
+    std::vector<Split> _splits;
+    const OctreeNode* _tree1 = nullptr;
+    const OctreeNode* _tree2 = nullptr;
+    uint64_t _generation1 = 0;
+    uint64_t _generation2 = 0;
+    uint64_t _version1 = 0;
+    uint64_t _version2 = 0;
+    size_t _visits = 0;
+
+    // Scratch buffers, kept to avoid allocating on every query.
+    std::vector<Pair> _next;
+    std::vector<Pair> _stack;
+    std::vector<uint32_t> _remap;
+
+    void _coarsen();
+
+ public:
+    void clear();
+
+    size_t size() const {
+        return this->_pairs.size();
+    }
+    size_t visits() const {
+        return this->_visits;
+    }
+};
+
+/**
+ * @brief Node of an octree over the triangles of a mesh, see Octree.
+ *
+ * Nodes live in the arena of their tree and own nothing: their bounds are
+ * plain values and everything else points into the arena or into the
+ * root's buffers. They are therefore trivially destructible, and the tree
+ * is released by rewinding or freeing the arena without visiting them.
+ * Queries can start from any node.
+ */
+class OctreeNode {
  private:
+    friend class Octree;
+
+    struct BuildState {
+        const std::vector<AABB>& boxes;
+        uint32_t* indices;  // index buffer of the root
+        TaskPool* pool;
+        TaskGroup& group;
+        std::atomic<size_t> nodes = 0;
+        std::atomic<size_t> leaves = 0;
+    };
+    struct Context;
+
+    typedef void (OctreeNode::*Builder)(BuildState& state, const AABB& cell);
+
     BoundingBox _bounds;
-    std::array<Octree*, 8> _children = {nullptr};
-    std::vector<Triangle> _members;
-    Octree* _root = nullptr;
+    std::array<OctreeNode*, 8> _children = {nullptr};
+    BoxPack _child_bounds;
+    TrianglePack* _packs = nullptr;  // leaf only, lives in the arena
+    uint32_t _pack_count = 0;
+    OctreeNode* _straddlers = nullptr;  // leaf over the front of a loose split
+    Context* _context = nullptr;
     int _level = 0;
+    uint32_t _first = 0;  // first member in the root's index buffer
+    uint32_t _count = 0;  // number of members
+    bool _built = false;
+    double _build_extent = 0;  // sum of the box extents when built
+    uint64_t _changed = 0;  // tree version of the last refit that moved it
 
- public:
-    explicit Octree(
-        const std::vector<Triangle>& triangles,
-        Octree* root = nullptr,
-        int level = 0
+    OctreeNode() = default;
+    OctreeNode(OctreeNode* parent, const OctantSplit& split, int octant);
+    OctreeNode(OctreeNode* parent, const OctantSplit& split);
+    OctreeNode(OctreeNode&& other) noexcept;
+    OctreeNode& operator=(OctreeNode&& other) noexcept;
+
+    template <OctreePolicy Policy>
+    void _build(BuildState& state, const AABB& cell);
+    size_t _enter(BuildState& state);
+    template <OctreePolicy Policy>
+    OctantSplit _partition(BuildState& state, const AABB& cell);
+    template <OctreePolicy Policy>
+    void _split(
+        const OctantSplit& split,
+        BuildState& state,
+        const AABB& cell
+    );
+    void _add_straddlers(const OctantSplit& split);
+    void _add_octant_children(const OctantSplit& split);
+    void _pack(BuildState& state);
+    void _pack_members();
+    std::array<OctreeNode*, 9> _parts() const;
+    void _set_builder(Builder builder);
+    AABB _box() const;
+    AABB _refit(const std::vector<AABB>& boxes, uint64_t version);
+    void _rebuild_degraded(
+        BuildState& state,
+        double threshold,
+        size_t& rebuilt
+    );
+    template <typename Stats = NoStats>
+    bool _leaf_intersects(
+        const OctreeNode& packed,
+        Stats stats = Stats()
+    ) const;
+    bool _leaf_intersects(
+        const OctreeNode& packed,
+        const Transform& transform
+    ) const;
+    template <typename Stats = NoStats>
+    static bool _leaves_intersect(
+        const OctreeNode* leaf1,
+        const OctreeNode* leaf2,
+        Stats stats = Stats()
+    );
+    static void _leaf_contacts(
+        const OctreeNode* leaf1,
+        const OctreeNode* leaf2,
+        ContactSink& sink
     );
-    std::array<Octree*, 8> children();
+    DistanceResult _nearest(OctreeNode* octree, double upper_bound, bool any);
+    RayHit _trace(const Ray& ray, double tmax, bool any);
+    void _trace_packet(
+        std::span<const Ray> rays,
+        std::span<RayHit> hits,
+        double tmax
+    ) const;
+    template <typename Stats = NoStats>
+    static void _push_children(
+        OctreeNode* tree1,
+        OctreeNode* tree2,
+        int position,
+        std::vector<OctreeNode*>& pairs,
+        Stats stats = Stats()
+    );
+    template <typename Stats = NoStats>
+    static bool _visit(
+        OctreeNode* tree1,
+        OctreeNode* tree2,
+        std::vector<OctreeNode*>& pairs,
+        Stats stats = Stats()
+    );
+    template <typename Stats>
+    bool _collides(OctreeNode* octree, Stats stats);
+
+ public:
+    OctreeNode(const OctreeNode&) = delete;
+    OctreeNode& operator=(const OctreeNode&) = delete;
+
+    const BuildStats& build(TaskPool* pool = nullptr);
+    std::array<OctreeNode*, 8> children();
     const BoundingBox& bounds() const;
     int level() const;
-    bool collides(Octree* octree);
+    uint32_t size() const {
+        return this->_count;
+    }
+    bool collides(OctreeNode* octree);
+    bool collides(OctreeNode* octree, TaskPool& pool);
+    bool collides(OctreeNode* octree, const Transform& transform);
+    bool collides(OctreeNode* octree, CollisionFront& front);
+    bool collides(OctreeNode* octree, QueryStats& stats);
+    size_t contacts(
+        OctreeNode* octree,
+        const ContactCallback& callback,
+        const ContactQuery& query = ContactQuery()
+    );
+    size_t contacts(
+        OctreeNode* octree,
+        std::span<Contact> buffer,
+        bool segments = false
+    );
+    DistanceResult distance(
+        OctreeNode* octree,
+        double upper_bound = std::numeric_limits<double>::infinity()
+    );
+    bool closer_than(OctreeNode* octree, double tolerance);
+    bool self_collides();
+    size_t self_contacts(
+        const ContactCallback& callback,
+        const ContactQuery& query = ContactQuery()
+    );
+    ImpactResult time_of_impact(
+        OctreeNode* octree,
+        const Motion& motion1,
+        const Motion& motion2
+    );
+    RayHit raycast(
+        const Ray& ray,
+        double tmax = std::numeric_limits<double>::infinity()
+    );
+    bool occluded(
+        const Ray& ray,
+        double tmax = std::numeric_limits<double>::infinity()
+    );
+    void raycast(
+        std::span<const Ray> rays,
+        std::span<RayHit> hits,
+        double tmax = std::numeric_limits<double>::infinity(),
+        TaskPool* pool = nullptr
+    );
     bool has_children();
+    OctreeNode* straddlers();
+    std::span<const TrianglePack> packs();
+    std::span<const uint32_t> members();
+    size_t arena_capacity() const;
 
     // helper functions
-    static int children_position(Octree* child1, Octree* child2);
+    static int children_position(OctreeNode* child1, OctreeNode* child2);
 };
 
+/**
+ * @brief Octree over the triangles of a mesh: the root node of the tree.
+ *
+ * The root owns everything the tree needs: the index buffer, the build
+ * statistics and an arena holding every other node and every leaf pack.
+ * Nodes never free memory; destroying or resetting the root releases the
+ * whole tree at once, and a reset tree is rebuilt into the arena it already
+ * has.
+ */
+class Octree : public OctreeNode {
+ private:
+    std::unique_ptr<Context> _owned;
+
+ public:
+    explicit Octree(std::shared_ptr<const IndexedMesh> mesh);
+    explicit Octree(const std::vector<Triangle>& triangles);
+    template <OctreePolicy Policy>
+    Octree(std::shared_ptr<const IndexedMesh> mesh, Policy policy);
+    template <OctreePolicy Policy>
+    Octree(const std::vector<Triangle>& triangles, Policy policy);
+    ~Octree();
+
+    Octree(Octree&& other) noexcept;
+    Octree& operator=(Octree&& other) noexcept;
+
+    void reset(std::shared_ptr<const IndexedMesh> mesh);
+    RefitStats refit(
+        std::vector<Vertex> positions,
+        double threshold = REFIT_THRESHOLD
+    );
+};
+
+/**
+ * @brief Construct a new Octree object subdivided by a policy instead of
+ * DefaultOctreePolicy. The policy is kept by reset() and refit().
+ *
+ * @param mesh mesh to store in the tree, can be shared with other engines
+ * @param policy subdivision policy, only its type is used
+ */
+template <OctreePolicy Policy>
+Octree::Octree(std::shared_ptr<const IndexedMesh> mesh, Policy)
+    : Octree(std::move(mesh)) {
+    this->_set_builder(&OctreeNode::_build<Policy>);
+}
+
+/**
+ * @brief Construct a new Octree object from a triangle soup, subdivided by
+ * a policy.
+ *
+ * @param triangles triangles to store in the tree
+ * @param policy subdivision policy, only its type is used
+ */
+template <OctreePolicy Policy>
+Octree::Octree(const std::vector<Triangle>& triangles, Policy policy)
+    : Octree(std::make_shared<const IndexedMesh>(triangles), policy) {}
+
+/**
+ * @brief Subdivide a node and, recursively, its children under a policy.
+ *
+ * Regular trees split every node around the center of its bounds. Loose
+ * trees split the cell of the node instead: the root's cell is its bounds
+ * and every child gets the octant of its parent's cell, whose loose cell,
+ * grown by the looseness, holds all of the child's members. A node whose
+ * members all fit in none of its loose octants therefore stays a leaf.
+ *
+ * @param state build state shared by the whole build
+ * @param cell cell of the node, only used by loose trees
+ */
+template <OctreePolicy Policy>
+void OctreeNode::_build(BuildState& state, const AABB& cell) {
+    const size_t total = this->_enter(state);
+
+    if (helpers::policy_splits<Policy>(this->_count, total, this->_level)) {
+        const AABB box = Policy::looseness > 0 ? cell : this->_box();
+        const OctantSplit split = this->_partition<Policy>(state, box);
+
+        if (split.straddlers < this->_count &&
+            helpers::policy_accepts<Policy>(split, this->_count)) {
+            this->_split<Policy>(split, state, box);
+            return;
+        }
+    }
+
+    this->_pack(state);
+}
+
+/**
+ * @brief Partition the members of a node into the octants of a cell, loose
+ * ones if the policy sets a looseness.
+ *
+ * @param state build state
+ * @param cell box split at its center
+ * @return OctantSplit partition of the members
+ */
+template <OctreePolicy Policy>
+OctantSplit OctreeNode::_partition(BuildState& state, const AABB& cell) {
+    YAAACD_TRACE_SPAN("Octree::partition");
+    uint32_t* members = state.indices + this->_first;
+
+    if constexpr (Policy::looseness > 0)
+        return helpers::partition_loose(
+            members,
+            this->_count,
+            state.boxes,
+            cell,
+            Policy::looseness
+        );
+    else
+        return helpers::partition_octants(
+            members,
+            this->_count,
+            state.boxes,
+            cell.center()
+        );
+}
+
+/**
+ * @brief Create the children of a node from a partition and build them
+ * under a policy.
+ *
+ * The straddlers of a loose split fit in no loose octant, so they stay with
+ * the node, at the front of its range, and are packed right away.
+ *
+ * @param split accepted partition of the node's members
+ * @param state build state
+ * @param cell cell that was partitioned
+ */
+template <OctreePolicy Policy>
+void OctreeNode::_split(
+    const OctantSplit& split,
+    BuildState& state,
+    const AABB& cell
+) {
+    if (split.straddlers) this->_add_straddlers(split);
+
+    this->_add_octant_children(split);
+    for (int i = 0; i < 8; i++) {
+        OctreeNode* child = this->_children[i];
+        if (!child) continue;
+
+        const AABB octant = helpers::octant_cell(cell, i);
+        if (state.pool && child->_count >= PARALLEL_GRAIN)
+            state.pool->submit(state.group, [child, octant, &state]() {
+                child->_build<Policy>(state, octant);
+            });
+        else
+            child->_build<Policy>(state, octant);
+    }
+}
+
 }  // namespace YAAACD
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./common.hpp"
+#include "./contacts.hpp"
+#include "./mesh.hpp"
+
+constexpr int PACK_WIDTH = 8;
+
+// Number of packs needed for the given number of triangles.
+constexpr size_t pack_count(size_t triangles) {
+    return (triangles + PACK_WIDTH - 1) / PACK_WIDTH;
+}
+
+namespace YAAACD {
+
+/**
+ * @brief Up to PACK_WIDTH triangles stored as structure-of-arrays.
+ *
+ * Coordinates are laid out as [vertex][axis][lane] so that one SIMD load
+ * fetches the same coordinate of the same vertex for a whole pack. Unused
+ * lanes repeat the last triangle and are masked out by `size`.
+ */
+struct alignas(64) TrianglePack {
+    double coordinates[3][3][PACK_WIDTH];
+    uint32_t ids[PACK_WIDTH];
+    uint32_t size = 0;
+
+    Triangle triangle(int lane) const;
+};
+
+std::vector<TrianglePack> pack_triangles(
+    const std::vector<Triangle>& triangles
+);
+void pack_triangles(
+    TrianglePack* packs,
+    const IndexedMesh& mesh,
+    const uint32_t* indices,
+    size_t count
+);
+void pack_triangles(
+    std::vector<TrianglePack>& packs,
+    const IndexedMesh& mesh,
+    const uint32_t* indices,
+    size_t count
+);
+
+namespace helpers {
+uint32_t pack_candidates(const Triangle& triangle, const TrianglePack& pack);
+bool pack_intersects(const Triangle& triangle, const TrianglePack& pack);
+bool pack_contacts(
+    const Triangle& triangle,
+    uint32_t id,
+    const TrianglePack& pack,
+    ContactSink& sink,
+    bool swapped = false
+);
+bool packs_intersect(
+    const std::vector<Triangle>& triangles,
+    const std::vector<TrianglePack>& packs
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./common.hpp"
+
+// A node is only split if none of its children would keep this share of the
+// node's members...
+constexpr double SPLIT_RATIO = 0.9;
+// ...and if it holds more than this share of all triangles of the tree.
+constexpr double MIN_SHARE = 0.025 / 100;
+
+namespace YAAACD {
+
+/**
+ * @brief Plain axis-aligned box, cheap to store per triangle.
+ */
+struct AABB {
+    Vertex lower;
+    Vertex upper;
+
+    AABB();
+    explicit AABB(const Triangle& triangle);
+
+    void extend(const AABB& box);
+    bool overlaps(const AABB& box) const;
+    Vertex center() const;
+    double area() const;
+};
+
+/**
+ * @brief Result of partitioning a node's members into octants.
+ *
+ * Members of octant i occupy [offsets[i], offsets[i + 1]) of the partitioned
+ * range and are enclosed by bounds[i]. Members that fit in no loose octant
+ * come first, in [0, straddlers), enclosed by straddler_bounds.
+ */
+struct OctantSplit {
+    std::array<uint32_t, 9> offsets = {0};
+    std::array<AABB, 8> bounds;
+    uint32_t straddlers = 0;
+    AABB straddler_bounds;
+
+    uint32_t count(int octant) const {
+        return this->offsets[octant + 1] - this->offsets[octant];
+    }
+};
+
+std::vector<AABB> triangle_bounds(const std::vector<Triangle>& triangles);
+
+namespace helpers {
+OctantSplit partition_octants(
+    uint32_t* indices,
+    uint32_t count,
+    const std::vector<AABB>& boxes,
+    const Vertex& center
+);
+OctantSplit partition_loose(
+    uint32_t* indices,
+    uint32_t count,
+    const std::vector<AABB>& boxes,
+    const AABB& cell,
+    double looseness
+);
+AABB octant_cell(const AABB& cell, int octant);
+bool should_split(uint32_t count, size_t total, int level);
+bool split_effective(
+    const OctantSplit& split,
+    uint32_t count,
+    double ratio = SPLIT_RATIO
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
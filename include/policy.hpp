@@ -0,0 +1,98 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "./common.hpp"
+#include "./partition.hpp"
+
+// Deepest level any octree policy may split to; sizes the traversal stacks.
+constexpr int MAX_DEPTH_LIMIT = 16;
+
+namespace YAAACD {
+
+/**
+ * @brief Compile-time subdivision rule of an octree.
+ *
+ * A node is split if it is above `depth_limit`, holds at least `leaf_size`
+ * members and more than `min_share` of all triangles of the tree; the
+ * partition is then kept unless an octant holds `split_ratio` of the
+ * node's members, otherwise the node becomes a leaf. Every value is a
+ * constant of the policy type, and the build is instantiated once per
+ * policy, so these tests and the choice of partition are folded into it.
+ *
+ * A positive `looseness`, at least 1, builds a loose octree, see
+ * LooseOctreePolicy.
+ *
+ * Trees are always built on double coordinates and AABB volumes, the types
+ * of the mesh, the SIMD packs and the exact predicates.
+ */
+template <typename Policy>
+concept OctreePolicy = requires {
+    { Policy::depth_limit } -> std::convertible_to<int>;
+    { Policy::leaf_size } -> std::convertible_to<uint32_t>;
+    { Policy::min_share } -> std::convertible_to<double>;
+    { Policy::split_ratio } -> std::convertible_to<double>;
+    { Policy::looseness } -> std::convertible_to<double>;
+} && Policy::depth_limit >= 0 && Policy::depth_limit <= MAX_DEPTH_LIMIT &&
+    (Policy::looseness == 0 || Policy::looseness >= 1);
+
+/**
+ * @brief Subdivision rule of the octree since its first version: at most
+ * DEPTH_LIMIT levels and MIN_MEMBERS members per split node, and partitions
+ * only kept if no octant holds SPLIT_RATIO of the members.
+ */
+struct DefaultOctreePolicy {
+    static constexpr int depth_limit = DEPTH_LIMIT;
+    static constexpr uint32_t leaf_size = MIN_MEMBERS;
+    static constexpr double min_share = MIN_SHARE;
+    static constexpr double split_ratio = SPLIT_RATIO;
+    static constexpr double looseness = 0;  // every member goes to an octant
+};
+
+/**
+ * @brief Loose octree. The root's cell is its bounds and every child's cell
+ * is an octant of its parent's cell. A member goes to the child whose cell,
+ * grown by `looseness` around its center, contains its box. Members fitting
+ * in no such loose cell stay with the node, in front of the members of its
+ * children, and queries test them along with the children. A node whose
+ * members all fit in no loose cell of its children stays a leaf, so every
+ * member is stored once, in the deepest node whose loose cell contains it.
+ * Large triangles then no longer stretch the bounds of small octants.
+ */
+struct LooseOctreePolicy : DefaultOctreePolicy {
+    static constexpr double looseness = 2;
+};
+
+namespace helpers {
+
+/**
+ * @brief Check if a node is large enough to be split under a policy.
+ *
+ * @param count number of members of the node
+ * @param total number of triangles in the whole tree
+ * @param level depth of the node
+ * @return true if the node should be partitioned
+ */
+template <OctreePolicy Policy>
+bool policy_splits(uint32_t count, size_t total, int level) {
+    return level < Policy::depth_limit && count >= Policy::leaf_size &&
+           count > Policy::min_share * total;
+}
+
+/**
+ * @brief Check if a partition is worth keeping under a policy.
+ *
+ * @param split partition of the node's members
+ * @param count number of members of the node
+ * @return true if the node should be split along the partition
+ */
+template <OctreePolicy Policy>
+bool policy_accepts(const OctantSplit& split, uint32_t count) {
+    return split_effective(split, count, Policy::split_ratio);
+}
+
+}  // namespace helpers
+
+}  // namespace YAAACD
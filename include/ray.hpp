@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "./common.hpp"
+#include "./distance.hpp"
+#include "./packs.hpp"
+
+// Number of rays traced together by the batched ray queries.
+constexpr int RAY_PACKET_WIDTH = 8;
+
+namespace YAAACD {
+
+/**
+ * @brief Half-line origin + t * direction, t >= 0. The direction does not
+ * need to be normalized; hit distances are measured in units of its length,
+ * so a segment from a to b is the ray (a, b - a) cut at t = 1.
+ */
+struct Ray {
+    Vertex origin;
+    Vertex direction;
+};
+
+/**
+ * @brief First triangle hit by a ray. `u` and `v` are the barycentric
+ * coordinates of the hit point with respect to the second and third vertex
+ * of the triangle.
+ */
+struct RayHit {
+    double distance = std::numeric_limits<double>::infinity();
+    uint32_t triangle = NO_TRIANGLE;
+    double u = 0;
+    double v = 0;
+
+    bool found() const {
+        return this->triangle != NO_TRIANGLE;
+    }
+};
+
+/**
+ * @brief Up to RAY_PACKET_WIDTH rays stored as structure-of-arrays, with
+ * their inverse directions and the distance up to which each ray is still
+ * looked for. Unused lanes have a negative limit and never hit anything.
+ */
+struct alignas(64) RayPacket {
+    double origin[3][RAY_PACKET_WIDTH];
+    double inverse[3][RAY_PACKET_WIDTH];
+    double limit[RAY_PACKET_WIDTH];
+
+    RayPacket(std::span<const Ray> rays, double tmax);
+};
+
+namespace helpers {
+Vertex ray_inverse(const Ray& ray);
+bool ray_box(
+    const Ray& ray,
+    const Vertex& inverse,
+    const BoundingBox& box,
+    double tmax,
+    double& entry
+);
+uint32_t ray_boxes(
+    const Ray& ray,
+    const Vertex& inverse,
+    const BoxPack& boxes,
+    double tmax,
+    double* entries
+);
+uint32_t packet_box(const RayPacket& packet, const BoundingBox& box);
+bool ray_triangle(
+    const Ray& ray,
+    const Triangle& triangle,
+    uint32_t id,
+    RayHit& hit
+);
+bool pack_raycast(const Ray& ray, const TrianglePack& pack, RayHit& hit);
+}  // namespace helpers
+
+}  // namespace YAAACD
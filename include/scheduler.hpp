@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace YAAACD {
+
+/**
+ * @brief Set of tasks that can be waited for as a unit. The first exception
+ * thrown by one of its tasks is kept and rethrown by TaskPool::wait().
+ */
+class TaskGroup {
+ private:
+    std::atomic<size_t> _pending = 0;
+    std::atomic<bool> _failed = false;
+    std::exception_ptr _error;  // set once, by the task flipping `_failed`
+
+    friend class TaskPool;
+
+ public:
+    bool done() const {
+        return this->_pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/**
+ * @brief Fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a deque: it pushes and pops its own tasks at the back
+ * (depth-first, cache friendly) while idle workers steal from the front of
+ * other deques (breadth-first, large subproblems). Tasks submitted from
+ * outside the pool go to a shared injection queue. Threads blocked in
+ * wait() execute tasks instead of sleeping, so nested waits cannot deadlock.
+ * The pool is meant to be created once and reused across queries.
+ */
+class TaskPool {
+ public:
+    typedef std::function<void()> Task;
+
+ private:
+    struct Entry {
+        Task task;
+        TaskGroup* group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Entry> entries;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;  // workers + injection
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _queued = 0;
+    std::atomic<bool> _stop = false;
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake;
+
+    void _worker(size_t index);
+    bool _try_run(size_t index);
+    bool _pop(size_t index, Entry& entry);
+    bool _steal(size_t index, Entry& entry);
+    void _run(Entry& entry);
+    size_t _current_queue() const;
+
+ public:
+    explicit TaskPool(size_t threads = std::thread::hardware_concurrency());
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void submit(TaskGroup& group, Task task);
+    void wait(TaskGroup& group);
+
+    size_t size() const {
+        return this->_threads.size();
+    }
+};
+
+}  // namespace YAAACD
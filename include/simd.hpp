@@ -0,0 +1,180 @@
+#pragma once
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace YAAACD::simd {
+
+/* SIMD BATCHES
+ * SIMD kernels are written once against this minimal batch interface, which
+ * maps to the widest instruction set the library is compiled for: AVX-512
+ * handles 8 doubles per operation, AVX2 4, SSE2 2 and the scalar fallback 1.
+ * Kernels over 8-lane data loop over 8 / Batch::WIDTH batches.
+ */
+
+#if defined(__AVX512F__)
+struct Batch {
+    static constexpr int WIDTH = 8;
+    __m512d value;
+
+    static Batch load(const double* data) {
+        return {_mm512_load_pd(data)};
+    }
+    static Batch broadcast(double value) {
+        return {_mm512_set1_pd(value)};
+    }
+    void store(double* data) const {
+        _mm512_storeu_pd(data, this->value);
+    }
+    friend Batch operator+(Batch a, Batch b) {
+        return {_mm512_add_pd(a.value, b.value)};
+    }
+    friend Batch operator-(Batch a, Batch b) {
+        return {_mm512_sub_pd(a.value, b.value)};
+    }
+    friend Batch operator*(Batch a, Batch b) {
+        return {_mm512_mul_pd(a.value, b.value)};
+    }
+    friend Batch operator/(Batch a, Batch b) {
+        return {_mm512_div_pd(a.value, b.value)};
+    }
+    friend Batch min(Batch a, Batch b) {
+        return {_mm512_min_pd(a.value, b.value)};
+    }
+    friend Batch max(Batch a, Batch b) {
+        return {_mm512_max_pd(a.value, b.value)};
+    }
+    friend Batch abs(Batch a) {
+        return {_mm512_abs_pd(a.value)};
+    }
+    friend uint32_t greater(Batch a, Batch b) {
+        return _mm512_cmp_pd_mask(a.value, b.value, _CMP_GT_OQ);
+    }
+};
+#elif defined(__AVX__)
+struct Batch {
+    static constexpr int WIDTH = 4;
+    __m256d value;
+
+    static Batch load(const double* data) {
+        return {_mm256_load_pd(data)};
+    }
+    static Batch broadcast(double value) {
+        return {_mm256_set1_pd(value)};
+    }
+    void store(double* data) const {
+        _mm256_storeu_pd(data, this->value);
+    }
+    friend Batch operator+(Batch a, Batch b) {
+        return {_mm256_add_pd(a.value, b.value)};
+    }
+    friend Batch operator-(Batch a, Batch b) {
+        return {_mm256_sub_pd(a.value, b.value)};
+    }
+    friend Batch operator*(Batch a, Batch b) {
+        return {_mm256_mul_pd(a.value, b.value)};
+    }
+    friend Batch operator/(Batch a, Batch b) {
+        return {_mm256_div_pd(a.value, b.value)};
+    }
+    friend Batch min(Batch a, Batch b) {
+        return {_mm256_min_pd(a.value, b.value)};
+    }
+    friend Batch max(Batch a, Batch b) {
+        return {_mm256_max_pd(a.value, b.value)};
+    }
+    friend Batch abs(Batch a) {
+        return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.value)};
+    }
+    friend uint32_t greater(Batch a, Batch b) {
+        return _mm256_movemask_pd(
+            _mm256_cmp_pd(a.value, b.value, _CMP_GT_OQ)
+        );
+    }
+};
+#elif defined(__SSE2__)
+struct Batch {
+    static constexpr int WIDTH = 2;
+    __m128d value;
+
+    static Batch load(const double* data) {
+        return {_mm_load_pd(data)};
+    }
+    static Batch broadcast(double value) {
+        return {_mm_set1_pd(value)};
+    }
+    void store(double* data) const {
+        _mm_storeu_pd(data, this->value);
+    }
+    friend Batch operator+(Batch a, Batch b) {
+        return {_mm_add_pd(a.value, b.value)};
+    }
+    friend Batch operator-(Batch a, Batch b) {
+        return {_mm_sub_pd(a.value, b.value)};
+    }
+    friend Batch operator*(Batch a, Batch b) {
+        return {_mm_mul_pd(a.value, b.value)};
+    }
+    friend Batch operator/(Batch a, Batch b) {
+        return {_mm_div_pd(a.value, b.value)};
+    }
+    friend Batch min(Batch a, Batch b) {
+        return {_mm_min_pd(a.value, b.value)};
+    }
+    friend Batch max(Batch a, Batch b) {
+        return {_mm_max_pd(a.value, b.value)};
+    }
+    friend Batch abs(Batch a) {
+        return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.value)};
+    }
+    friend uint32_t greater(Batch a, Batch b) {
+        return _mm_movemask_pd(_mm_cmpgt_pd(a.value, b.value));
+    }
+};
+#else
+struct Batch {
+    static constexpr int WIDTH = 1;
+    double value;
+
+    static Batch load(const double* data) {
+        return {*data};
+    }
+    static Batch broadcast(double value) {
+        return {value};
+    }
+    void store(double* data) const {
+        *data = this->value;
+    }
+    friend Batch operator+(Batch a, Batch b) {
+        return {a.value + b.value};
+    }
+    friend Batch operator-(Batch a, Batch b) {
+        return {a.value - b.value};
+    }
+    friend Batch operator*(Batch a, Batch b) {
+        return {a.value * b.value};
+    }
+    friend Batch operator/(Batch a, Batch b) {
+        return {a.value / b.value};
+    }
+    friend Batch min(Batch a, Batch b) {
+        return {std::min(a.value, b.value)};
+    }
+    friend Batch max(Batch a, Batch b) {
+        return {std::max(a.value, b.value)};
+    }
+    friend Batch abs(Batch a) {
+        return {std::fabs(a.value)};
+    }
+    friend uint32_t greater(Batch a, Batch b) {
+        return a.value > b.value;
+    }
+};
+#endif
+
+}  // namespace YAAACD::simd
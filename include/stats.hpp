@@ -0,0 +1,145 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace YAAACD {
+
+/**
+ * @brief Counters and phase timers of collision queries.
+ *
+ * For an octree, pairs are node pairs and leaf tests are leaf pairs. For a
+ * spatial hash map, pairs are candidate triangle pairs met in grid cells,
+ * pruned when their boxes are disjoint or when they are met outside their
+ * reference cell, and leaf tests are the non-empty cells visited.
+ *
+ * Stats add up over the queries they are passed to.
+ */
+struct QueryStats {
+    uint64_t visited_pairs = 0;
+    uint64_t pruned_pairs = 0;  // pairs dropped by a box test
+    uint64_t box_tests = 0;  // box overlap tests, batched ones count once
+    uint64_t leaf_tests = 0;
+    uint64_t triangle_tests = 0;  // triangle pairs tested
+    uint64_t build_ns = 0;  // trees built on demand by the query
+    uint64_t traversal_ns = 0;  // traversal, without the leaf tests
+    uint64_t leaf_ns = 0;  // triangle tests
+
+    uint64_t total_ns() const {
+        return this->build_ns + this->traversal_ns + this->leaf_ns;
+    }
+
+    QueryStats& operator+=(const QueryStats& other) {
+        this->visited_pairs += other.visited_pairs;
+        this->pruned_pairs += other.pruned_pairs;
+        this->box_tests += other.box_tests;
+        this->leaf_tests += other.leaf_tests;
+        this->triangle_tests += other.triangle_tests;
+        this->build_ns += other.build_ns;
+        this->traversal_ns += other.traversal_ns;
+        this->leaf_ns += other.leaf_ns;
+        return *this;
+    }
+};
+
+/**
+ * @brief Stats policy of regular queries: every call is empty, so the
+ * instrumented traversals compile to the same code as uninstrumented ones.
+ */
+struct NoStats {
+    static constexpr bool enabled = false;
+
+    struct Timer {};
+
+    void visit() const {}
+    void prune(uint64_t = 1) const {}
+    void box_test() const {}
+    void leaf_test() const {}
+    void triangle_tests(uint64_t) const {}
+    Timer time(
+        uint64_t QueryStats::*,
+        uint64_t QueryStats::* = nullptr
+    ) const {
+        return {};
+    }
+};
+
+/**
+ * @brief Stats policy recording into a QueryStats. Timing reads the clock
+ * twice per leaf test, which slows down queries testing many small leaves.
+ */
+class RecordStats {
+ private:
+    QueryStats* _stats;
+
+ public:
+    static constexpr bool enabled = true;
+
+    /**
+     * @brief Adds the time it lives to a phase, minus the time added to a
+     * nested phase meanwhile.
+     */
+    class Timer {
+     private:
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t& _phase;
+        const uint64_t* _nested;
+        uint64_t _nested_start;
+        Clock::time_point _start;
+
+     public:
+        Timer(uint64_t& phase, const uint64_t* nested)
+            : _phase(phase),
+              _nested(nested),
+              _nested_start(nested ? *nested : 0),
+              _start(Clock::now()) {}
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer() {
+            const auto elapsed = std::chrono::duration_cast<
+                std::chrono::nanoseconds>(Clock::now() - this->_start);
+            const uint64_t nested =
+                this->_nested ? *this->_nested - this->_nested_start : 0;
+
+            this->_phase += elapsed.count() - nested;
+        }
+    };
+
+    explicit RecordStats(QueryStats& stats) : _stats(&stats) {}
+
+    void visit() const {
+        this->_stats->visited_pairs++;
+    }
+    void prune(uint64_t pairs = 1) const {
+        this->_stats->pruned_pairs += pairs;
+    }
+    void box_test() const {
+        this->_stats->box_tests++;
+    }
+    void leaf_test() const {
+        this->_stats->leaf_tests++;
+    }
+    void triangle_tests(uint64_t pairs) const {
+        this->_stats->triangle_tests += pairs;
+    }
+
+    /**
+     * @brief Start timing a phase until the returned timer is destroyed.
+     *
+     * @param phase phase to add the time to
+     * @param nested phase timed within this one, whose time is not counted
+     */
+    Timer time(
+        uint64_t QueryStats::*phase,
+        uint64_t QueryStats::*nested = nullptr
+    ) const {
+        return Timer(
+            this->_stats->*phase,
+            nested ? &(this->_stats->*nested) : nullptr
+        );
+    }
+};
+
+}  // namespace YAAACD
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Spans kept per thread; once a buffer is full the oldest ones are
+// overwritten.
+constexpr size_t TRACE_BUFFER_SIZE = 1 << 16;
+
+namespace YAAACD::trace {
+
+/**
+ * @brief Whether the library was built with its spans, see
+ * YAAACD_TRACE_SPAN.
+ */
+#ifdef YAAACD_ENABLE_TRACING
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+struct Event {
+    const char* name;
+    uint64_t start;  // steady clock, in nanoseconds
+    uint64_t duration;  // nanoseconds
+};
+
+uint64_t now();
+void record(const char* name, uint64_t start, uint64_t end);
+void write_chrome_json(std::ostream& out);
+void clear();
+
+/**
+ * @brief Records the time it lives as a span of the calling thread.
+ */
+class Span {
+ private:
+    const char* _name;
+    uint64_t _start;
+
+ public:
+    explicit Span(const char* name) : _name(name), _start(now()) {}
+    ~Span() {
+        record(this->_name, this->_start, now());
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+};
+
+}  // namespace YAAACD::trace
+
+/* TRACING
+ * YAAACD_TRACE_SPAN("name") records the rest of the enclosing scope as a
+ * span named by the string literal. Spans are only compiled in when
+ * YAAACD_ENABLE_TRACING is defined (CMake option YAAACD_TRACING); otherwise
+ * the macro expands to nothing and costs nothing.
+ */
+#ifdef YAAACD_ENABLE_TRACING
+#define YAAACD_TRACE_CONCAT_(a, b) a##b
+#define YAAACD_TRACE_CONCAT(a, b) YAAACD_TRACE_CONCAT_(a, b)
+#define YAAACD_TRACE_SPAN(name) \
+    const YAAACD::trace::Span YAAACD_TRACE_CONCAT(yaaacd_span_, __LINE__)(name)
+#else
+#define YAAACD_TRACE_SPAN(name) static_cast<void>(0)
+#endif
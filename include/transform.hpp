@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+
+#include "./common.hpp"
+
+// Slack added to the rotation terms of the separating axis test, so that
+// nearly parallel edges never produce a false separation.
+constexpr double SAT_EPSILON = 1e-9;
+
+namespace YAAACD {
+
+typedef std::array<std::array<double, 3>, 3> Rotation;
+
+/**
+ * @brief Rigid transformation: a rotation followed by a translation.
+ *
+ * The rotation is stored as a row-major matrix, so its columns are the
+ * images of the coordinate axes.
+ */
+struct Transform {
+    Rotation rotation = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+    Vertex translation;
+
+    Transform() {}
+    Transform(const Rotation& rotation, const Vertex& translation);
+
+    static Transform rotation_about(
+        const Vertex& axis,
+        double angle,
+        const Vertex& translation = Vertex()
+    );
+
+    Vertex apply(const Vertex& vertex) const;
+    Triangle apply(const Triangle& triangle) const;
+    Transform inverse() const;
+    Transform operator*(const Transform& other) const;
+};
+
+namespace helpers {
+bool boxes_overlap(
+    const BoundingBox& box1,
+    const BoundingBox& box2,
+    const Transform& transform
+);
+}  // namespace helpers
+
+}  // namespace YAAACD
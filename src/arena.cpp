@@ -0,0 +1,118 @@
+#include "../include/arena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+using namespace YAAACD;
+
+// Alignment of every block, enough for SIMD packs.
+constexpr size_t BLOCK_ALIGNMENT = 64;
+
+/**
+ * @brief Construct a new, empty Arena object.
+ *
+ * @param block_size size of the blocks requested from the system; larger
+ * allocations get a block of their own
+ */
+Arena::Arena(size_t block_size) : _block_size(block_size) {}
+
+Arena::~Arena() {
+    for (const Block& block : this->_blocks)
+        ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+}
+
+/**
+ * @brief Return the first offset at or after `offset` whose address in the
+ * block is a multiple of `alignment`.
+ */
+static size_t align_offset(
+    const std::byte* block,
+    size_t offset,
+    size_t alignment
+) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(block) + offset;
+
+    return offset + (alignment - address % alignment) % alignment;
+}
+
+/**
+ * @brief Bump-allocate from the current block. A request that does not fit
+ * moves on to the first unused block that fits, or to a new one; the unused
+ * blocks it passes over stay available for later requests.
+ */
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    if (this->_block < this->_blocks.size()) {
+        const Block& block = this->_blocks[this->_block];
+        const size_t offset =
+            align_offset(block.data, this->_offset, alignment);
+
+        if (offset + bytes <= block.size) {
+            this->_offset = offset + bytes;
+            return block.data + offset;
+        }
+
+        // An untouched block is kept as a candidate for the search below.
+        if (this->_offset > 0) this->_block++;
+    }
+
+    // Blocks from the current one on are unused since the last reset.
+    auto fits = [bytes, alignment](const Block& block) {
+        return align_offset(block.data, 0, alignment) + bytes <= block.size;
+    };
+    auto found = std::find_if(
+        this->_blocks.begin() + this->_block,
+        this->_blocks.end(),
+        fits
+    );
+    if (found == this->_blocks.end()) {
+        // Large enough for the request whatever the alignment.
+        const size_t size = std::max(this->_block_size, bytes + alignment);
+        this->_blocks.push_back(
+            {static_cast<std::byte*>(
+                 ::operator new(size, std::align_val_t(BLOCK_ALIGNMENT))
+             ),
+             size}
+        );
+        found = this->_blocks.end() - 1;
+    }
+    std::iter_swap(this->_blocks.begin() + this->_block, found);
+
+    const Block& block = this->_blocks[this->_block];
+    const size_t offset = align_offset(block.data, 0, alignment);
+    this->_offset = offset + bytes;
+
+    return block.data + offset;
+}
+
+/**
+ * @brief Release everything allocated so far in O(1), keeping the blocks
+ * for later allocations.
+ *
+ * Objects living in the arena must not be used afterwards; their
+ * destructors are not called.
+ */
+void Arena::reset() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    this->_block = 0;
+    this->_offset = 0;
+}
+
+/**
+ * @brief Total size of the blocks owned by the arena.
+ *
+ * @return size_t capacity in bytes
+ */
+size_t Arena::capacity() const {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    size_t capacity = 0;
+    for (const Block& block : this->_blocks) capacity += block.size;
+
+    return capacity;
+}
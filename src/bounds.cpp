@@ -1,43 +1,69 @@
 #include <algorithm>
 #include <array>
-#include <deque>
-#include <memory>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 #include "../include/common.hpp"
+#include "../include/simd.hpp"
 
 constexpr int RIGHT = 0b100;
 constexpr int TOP = 0b010;
 constexpr int FRONT = 0b001;
 
 using namespace YAAACD;
+using YAAACD::simd::Batch;
 
 /**
  * @brief Check if 2 AABBs intersect.
  *
+ * Boxes intersect iff their intervals overlap on all three axes.
+ *
  * @param box AABB to check against
  * @return true if boxes intersect
  * @return false if boxes don't intersect
  */
 bool BoundingBox::intersects(const BoundingBox &box) const {
-    if (std::any_of(
-            this->_corners.begin(),
-            this->_corners.end(),
-            [&box](const Vertex &vertex) {
-                return box.contains(vertex);
-            }
-        ))
-        return true;
+    return this->_lower.x <= box._upper.x && box._lower.x <= this->_upper.x &&
+           this->_lower.y <= box._upper.y && box._lower.y <= this->_upper.y &&
+           this->_lower.z <= box._upper.z && box._lower.z <= this->_upper.z;
+}
 
-    const std::array<Vertex, 8> &box_corners = box.corners();
+/**
+ * @brief Check which of up to 8 AABBs intersect this one in a single pass.
+ *
+ * @param boxes packed AABBs to check against
+ * @return uint8_t bitmask with bit i set if the i-th box intersects
+ */
+uint8_t BoundingBox::intersects(const BoxPack &boxes) const {
+    const std::array<double, 3> lower = {
+        this->_lower.x,
+        this->_lower.y,
+        this->_lower.z
+    };
+    const std::array<double, 3> upper = {
+        this->_upper.x,
+        this->_upper.y,
+        this->_upper.z
+    };
 
-    return std::any_of(
-        box_corners.begin(),
-        box_corners.end(),
-        [&](const Vertex &vertex) {
-            return this->contains(vertex);
+    uint32_t separated = 0;
+    for (int offset = 0; offset < 8; offset += Batch::WIDTH) {
+        uint32_t batch_separated = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            batch_separated |= greater(
+                Batch::load(&boxes.lower[axis][offset]),
+                Batch::broadcast(upper[axis])
+            );
+            batch_separated |= greater(
+                Batch::broadcast(lower[axis]),
+                Batch::load(&boxes.upper[axis][offset])
+            );
         }
-    );
+        separated |= batch_separated << offset;
+    }
+
+    return ~separated & 0xff;
 }
 
 /**
@@ -65,11 +91,9 @@ bool BoundingBox::contains(const Triangle &triangle) const {
  * @return false if AABB doesn't contain the vertex
  */
 const bool BoundingBox::contains(const Vertex &vertex) const {
-    auto [x, y, z] = vertex.coordinates();
-
-    return x >= this->_corners[!RIGHT].x && x <= this->_corners[RIGHT].x &&
-           y >= this->_corners[!TOP].y && y <= this->_corners[TOP].y &&
-           z >= this->_corners[!FRONT].z && z <= this->_corners[FRONT].z;
+    return vertex.x >= this->_lower.x && vertex.x <= this->_upper.x &&
+           vertex.y >= this->_lower.y && vertex.y <= this->_upper.y &&
+           vertex.z >= this->_lower.z && vertex.z <= this->_upper.z;
 }
 
 /**
@@ -77,18 +101,12 @@ const bool BoundingBox::contains(const Vertex &vertex) const {
  *
  * @return Vertex center of the bounding box
  */
-Vertex BoundingBox::center() {
-    if (!this->_center) {
-        this->_center = new Vertex(
-            (this->_corners[0].x + this->_corners[4].x) /
-                2,  // (left + right)/2
-            (this->_corners[0].y + this->_corners[2].y) /
-                2,                                           // (bottom + top)/2
-            (this->_corners[0].z + this->_corners[1].z) / 2  // (rear + front)/2
-        );
-    }
-
-    return *(this->_center);
+Vertex BoundingBox::center() const {
+    return Vertex(
+        (this->_lower.x + this->_upper.x) / 2,  // (left + right)/2
+        (this->_lower.y + this->_upper.y) / 2,  // (bottom + top)/2
+        (this->_lower.z + this->_upper.z) / 2   // (rear + front)/2
+    );
 }
 
 /**
@@ -98,7 +116,21 @@ Vertex BoundingBox::center() {
  * @param level depth
  */
 BoundingBox::BoundingBox(const std::array<Vertex, 8> &corners, int level) {
-    this->_corners = corners;
+    this->_lower = corners[0];
+    this->_upper = corners[RIGHT | TOP | FRONT];
+    this->_level = level;
+}
+
+/**
+ * @brief Construct a new BoundingBox object from its extreme corners.
+ *
+ * @param lower left bottom rear corner
+ * @param upper right top front corner
+ * @param level depth
+ */
+BoundingBox::BoundingBox(const Vertex &lower, const Vertex &upper, int level) {
+    this->_lower = lower;
+    this->_upper = upper;
     this->_level = level;
 }
 
@@ -108,87 +140,64 @@ BoundingBox::BoundingBox(const std::array<Vertex, 8> &corners, int level) {
  * @param vertices vertices contained by the bounding box
  */
 BoundingBox::BoundingBox(const std::vector<Vertex> &vertices) {
-    std::vector<double> x;
-    std::vector<double> y;
-    std::vector<double> z;
-
-    std::for_each(vertices.begin(), vertices.end(), [&](Vertex const &vertex) {
-        x.push_back(vertex.x);
-        y.push_back(vertex.y);
-        z.push_back(vertex.z);
-    });
-
-    // X
-    double left = *std::min_element(x.begin(), x.end());
-    double right = *std::max_element(x.begin(), x.end());
-
-    // Y
-    double bottom = *std::min_element(y.begin(), y.end());
-    double top = *std::max_element(y.begin(), y.end());
-
-    // Z
-    double rear = *std::min_element(z.begin(), z.end());
-    double front = *std::max_element(z.begin(), z.end());
-
-    this->_corners = {
-        Vertex(left, bottom, rear),
-        Vertex(left, bottom, front),
-        Vertex(left, top, rear),
-        Vertex(left, top, front),
-        Vertex(right, bottom, rear),
-        Vertex(right, bottom, front),
-        Vertex(right, top, rear),
-        Vertex(right, top, front),
-    };
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    this->_lower = Vertex(inf, inf, inf);
+    this->_upper = Vertex(-inf, -inf, -inf);
+
+    for (const Vertex &vertex : vertices) {
+        this->_lower = Vertex(
+            std::min(this->_lower.x, vertex.x),
+            std::min(this->_lower.y, vertex.y),
+            std::min(this->_lower.z, vertex.z)
+        );
+        this->_upper = Vertex(
+            std::max(this->_upper.x, vertex.x),
+            std::max(this->_upper.y, vertex.y),
+            std::max(this->_upper.z, vertex.z)
+        );
+    }
 }
 
-__attribute__((annotate("oclint:suppress[bitwise operator in conditional]")))
-std::array<BoundingBox *, 8>
-BoundingBox::children() {
-    if (std::any_of(
-            this->_children.begin(),
-            this->_children.end(),
-            [](BoundingBox *box) {
-                return box != nullptr;
-            }
-        ) ||
-        this->_level >= DEPTH_LIMIT)
-        return this->_children;
+/**
+ * @brief Return the 8 octants of the AABB, one level below it, indexed by
+ * RIGHT | TOP | FRONT.
+ *
+ * @return std::array<BoundingBox, 8> octants
+ */
+std::array<BoundingBox, 8> BoundingBox::children() const {
+    std::array<BoundingBox, 8> children;
 
     Boundaries parent_boundaries(
-        this->_corners[0].x,
-        this->_corners[RIGHT].x,
-        this->_corners[0].y,
-        this->_corners[TOP].y,
-        this->_corners[0].z,
-        this->_corners[FRONT].z
+        this->_lower.x,
+        this->_upper.x,
+        this->_lower.y,
+        this->_upper.y,
+        this->_lower.z,
+        this->_upper.z
     );
 
     for (int i = 0; i < 8; i++) {
         auto [_left, _right, _bottom, _top, _rear, _front] =
             this->_child_boundaries(i, parent_boundaries);
 
-        const std::array<Vertex, 8> child_corners = {
+        children[i] = BoundingBox(
             Vertex(_left, _bottom, _rear),
-            Vertex(_left, _bottom, _front),
-            Vertex(_left, _top, _rear),
-            Vertex(_left, _top, _front),
-            Vertex(_right, _bottom, _rear),
-            Vertex(_right, _bottom, _front),
-            Vertex(_right, _top, _rear),
             Vertex(_right, _top, _front),
-        };
-
-        this->_children[i] = new BoundingBox(child_corners, this->_level + 1);
+            this->_level + 1
+        );
     }
 
-    return this->_children;
+    return children;
 }
 
 const Boundaries __attribute__((
     annotate("oclint:suppress[bitwise operator in conditional]")
 ))
-BoundingBox::_child_boundaries(int index, const Boundaries &parent_boundaries) {
+BoundingBox::_child_boundaries(
+    int index,
+    const Boundaries &parent_boundaries
+) const {
     auto [left, right, bottom, top, rear, front] = parent_boundaries;
     auto __center = this->center();
 
@@ -221,53 +230,56 @@ BoundingBox::_child_boundaries(int index, const Boundaries &parent_boundaries) {
     return child_boundaries;
 }
 
-const std::array<Vertex, 8> &BoundingBox::corners() const {
-    return this->_corners;
+/**
+ * @brief Return the 8 corners of the AABB, indexed by RIGHT | TOP | FRONT.
+ *
+ * @return const std::array<Vertex, 8> corners
+ */
+__attribute__((annotate("oclint:suppress[bitwise operator in conditional]")))
+const std::array<Vertex, 8> BoundingBox::corners() const {
+    std::array<Vertex, 8> corners;
+
+    for (int i = 0; i < 8; i++)
+        corners[i] = Vertex(
+            (i & RIGHT) == RIGHT ? this->_upper.x : this->_lower.x,
+            (i & TOP) == TOP ? this->_upper.y : this->_lower.y,
+            (i & FRONT) == FRONT ? this->_upper.z : this->_lower.z
+        );
+
+    return corners;
 }
 
-std::vector<BoundingBox *>
-BoundingBox::split(int level, const std::vector<Triangle> &triangles) {
-    std::deque<BoundingBox *> queue;
-    auto this_children = this->children();
-    std::for_each(
-        this_children.begin(),
-        this_children.end(),
-        [&queue, &triangles](BoundingBox *child) {
-            queue.push_back(child);
-            std::copy_if(
-                triangles.begin(),
-                triangles.end(),
-                std::back_inserter(child->members()),
-                [&child](const Triangle &triangle) {
-                    return child->contains(triangle);
-                }
-            );
+/**
+ * @brief Construct an empty BoxPack, with every lane inverted.
+ */
+BoxPack::BoxPack() {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    for (int axis = 0; axis < 3; axis++)
+        for (int i = 0; i < 8; i++) {
+            this->lower[axis][i] = inf;
+            this->upper[axis][i] = -inf;
         }
-    );
+}
 
-    while (queue.front()->level() != level) {
-        std::array<BoundingBox *, 8> box_children = queue.front()->children();
-        std::for_each(
-            box_children.begin(),
-            box_children.end(),
-            [&queue](BoundingBox *child) {
-                queue.push_back(child);
-                std::copy_if(
-                    queue.front()->members().begin(),
-                    queue.front()->members().end(),
-                    std::back_inserter(child->members()),
-                    [&child](const Triangle &triangle) {
-                        return child->contains(triangle);
-                    }
-                );
-            }
-        );
-        queue.pop_front();
+/**
+ * @brief Pack up to 8 AABBs; null entries become inverted lanes.
+ *
+ * @param boxes boxes to pack
+ */
+BoxPack::BoxPack(const std::array<const BoundingBox *, 8> &boxes) : BoxPack() {
+    for (int i = 0; i < 8; i++) {
+        if (!boxes[i]) continue;
+
+        const Vertex &box_lower = boxes[i]->lower();
+        const Vertex &box_upper = boxes[i]->upper();
+        this->lower[0][i] = box_lower.x;
+        this->lower[1][i] = box_lower.y;
+        this->lower[2][i] = box_lower.z;
+        this->upper[0][i] = box_upper.x;
+        this->upper[1][i] = box_upper.y;
+        this->upper[2][i] = box_upper.z;
     }
-
-    std::vector<BoundingBox *> retval(std::begin(queue), std::end(queue));
-
-    return retval;
 }
 
 /*
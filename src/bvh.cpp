@@ -0,0 +1,343 @@
+#include "../include/bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "../include/packs.hpp"
+#include "../include/partition.hpp"
+
+using namespace YAAACD;
+
+static AABB to_AABB(const BoundingBox& box) {
+    AABB result;
+    result.lower = box.lower();
+    result.upper = box.upper();
+
+    return result;
+}
+
+static double coordinate(const Vertex& vertex, int axis) {
+    return axis == 0 ? vertex.x : (axis == 1 ? vertex.y : vertex.z);
+}
+
+/**
+ * @brief SAH bin of a centroid coordinate within [lower, lower + extent].
+ */
+static int bin_of(double center, double lower, double extent) {
+    const int bin = SAH_BINS * (center - lower) / extent;
+
+    return std::min(bin, SAH_BINS - 1);
+}
+
+/**
+ * @brief Construct a new Bvh object.
+ *
+ * @param mesh mesh to store in the hierarchy, can be shared with other
+ * engines
+ */
+Bvh::Bvh(std::shared_ptr<const IndexedMesh> mesh) {
+    this->_mesh = std::move(mesh);
+
+    if (!this->_mesh->size()) return;
+
+    const std::vector<AABB> boxes = triangle_bounds(*this->_mesh);
+    this->_indices.resize(this->_mesh->size());
+    for (uint32_t i = 0; i < this->_indices.size(); i++) this->_indices[i] = i;
+
+    this->_nodes.reserve(2 * this->_mesh->size());
+    this->_nodes.emplace_back();
+    this->_build(0, boxes, 0, this->_mesh->size());
+}
+
+/**
+ * @brief Construct a new Bvh object from a triangle soup.
+ *
+ * @param triangles triangles to store in the hierarchy
+ */
+Bvh::Bvh(const std::vector<Triangle>& triangles)
+    : Bvh(std::make_shared<const IndexedMesh>(triangles)) {}
+
+/**
+ * @brief Split a node with the binned surface area heuristic.
+ *
+ * The centroids of the members are sorted into SAH_BINS bins along each
+ * axis and every boundary between two bins is evaluated as a split plane.
+ * The cheapest plane wins unless keeping the node as a leaf is cheaper;
+ * nodes larger than MAX_LEAF_SIZE are always split. The node's range of
+ * the index buffer is partitioned in place.
+ *
+ * @param node index of the node
+ * @param boxes AABBs of all triangles
+ * @param first first member of the node
+ * @param count number of members of the node
+ */
+void Bvh::_build(
+    uint32_t node,
+    const std::vector<AABB>& boxes,
+    uint32_t first,
+    uint32_t count
+) {
+    uint32_t* members = this->_indices.data() + first;
+
+    AABB bounds;
+    AABB centroids;
+    for (uint32_t i = 0; i < count; i++) {
+        const AABB& box = boxes[members[i]];
+        AABB centroid;
+        centroid.lower = centroid.upper = box.center();
+
+        bounds.extend(box);
+        centroids.extend(centroid);
+    }
+    this->_nodes[node].bounds = bounds;
+
+    struct Bin {
+        AABB bounds;
+        uint32_t count = 0;
+    };
+
+    const double area = bounds.area();
+    double best_cost = std::numeric_limits<double>::infinity();
+    int best_axis = -1;
+    int best_bin = 0;
+
+    for (int axis = 0; axis < 3 && area > 0; axis++) {
+        const double lower = coordinate(centroids.lower, axis);
+        const double extent = coordinate(centroids.upper, axis) - lower;
+        if (extent <= 0) continue;
+
+        std::array<Bin, SAH_BINS> bins;
+        for (uint32_t i = 0; i < count; i++) {
+            const AABB& box = boxes[members[i]];
+            const double center = coordinate(box.center(), axis);
+            Bin& bin = bins[bin_of(center, lower, extent)];
+
+            bin.bounds.extend(box);
+            bin.count++;
+        }
+
+        // Right-to-left sweep first, then evaluate every plane left to right.
+        std::array<double, SAH_BINS> right_area;
+        std::array<uint32_t, SAH_BINS> right_count;
+        AABB right;
+        uint32_t right_members = 0;
+        for (int i = SAH_BINS - 1; i > 0; i--) {
+            right.extend(bins[i].bounds);
+            right_members += bins[i].count;
+            right_area[i] = right.area();
+            right_count[i] = right_members;
+        }
+
+        AABB left;
+        uint32_t left_members = 0;
+        for (int i = 0; i < SAH_BINS - 1; i++) {
+            left.extend(bins[i].bounds);
+            left_members += bins[i].count;
+            if (!left_members || !right_count[i + 1]) continue;
+
+            const double cost = SAH_TRAVERSAL_COST +
+                                SAH_INTERSECTION_COST *
+                                    (left.area() * left_members +
+                                     right_area[i + 1] * right_count[i + 1]) /
+                                    area;
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = i;
+            }
+        }
+    }
+
+    const double leaf_cost = SAH_INTERSECTION_COST * count;
+    const bool small = count <= MAX_LEAF_SIZE;
+    if (small && (best_axis < 0 || best_cost >= leaf_cost)) {
+        this->_nodes[node].first = first;
+        this->_nodes[node].count = count;
+        this->_nodes[node].pack = this->_packs.size();
+        pack_triangles(this->_packs, *this->_mesh, members, count);
+        return;
+    }
+
+    uint32_t middle = count / 2;
+    if (best_axis >= 0) {
+        const double lower = coordinate(centroids.lower, best_axis);
+        const double extent =
+            coordinate(centroids.upper, best_axis) - lower;
+
+        uint32_t* split = std::partition(
+            members,
+            members + count,
+            [&](uint32_t index) {
+                const double center =
+                    coordinate(boxes[index].center(), best_axis);
+                return bin_of(center, lower, extent) <= best_bin;
+            }
+        );
+        middle = split - members;
+    }
+
+    const uint32_t left = this->_nodes.size();
+    this->_nodes[node].first = left;
+    this->_nodes.resize(left + 2);
+
+    this->_build(left, boxes, first, middle);
+    this->_build(left + 1, boxes, first + middle, count - middle);
+}
+
+bool Bvh::_leaf_intersects(
+    const Node& leaf,
+    std::span<const TrianglePack> packs
+) const {
+    for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++)
+        for (const TrianglePack& pack : packs)
+            if (helpers::pack_intersects(
+                    this->_mesh->triangle(this->_indices[i]),
+                    pack
+                ))
+                return true;
+
+    return false;
+}
+
+bool Bvh::_leaves_intersect(
+    const Node& leaf1,
+    const Bvh& other,
+    const Node& leaf2
+) const {
+    // The larger leaf is tested in SIMD packs, the smaller one triangle by
+    // triangle.
+    if (leaf1.count > leaf2.count)
+        return other._leaves_intersect(leaf2, *this, leaf1);
+
+    const uint32_t packs = pack_count(leaf2.count);
+
+    for (uint32_t i = leaf1.first; i < leaf1.first + leaf1.count; i++)
+        for (uint32_t j = leaf2.pack; j < leaf2.pack + packs; j++)
+            if (helpers::pack_intersects(
+                    this->_mesh->triangle(this->_indices[i]),
+                    other._packs[j]
+                ))
+                return true;
+
+    return false;
+}
+
+/**
+ * @brief Check if two hierarchies collide.
+ *
+ * Overlapping node pairs are refined by descending into the node with the
+ * larger surface area (or the only inner one), and leaf pairs are resolved
+ * with triangle-triangle tests.
+ *
+ * @param other hierarchy to check against
+ * @return true if any pair of triangles intersects
+ */
+bool Bvh::collides(const Bvh& other) const {
+    if (this->_nodes.empty() || other._nodes.empty()) return false;
+
+    std::vector<std::array<uint32_t, 2>> pairs = {{0, 0}};
+
+    while (!pairs.empty()) {
+        auto [index1, index2] = pairs.back();
+        pairs.pop_back();
+
+        const Node& node1 = this->_nodes[index1];
+        const Node& node2 = other._nodes[index2];
+
+        if (!node1.bounds.overlaps(node2.bounds)) continue;
+
+        if (node1.is_leaf() && node2.is_leaf()) {
+            if (this->_leaves_intersect(node1, other, node2)) return true;
+        } else if (node2.is_leaf() ||
+                   (!node1.is_leaf() &&
+                    node1.bounds.area() >= node2.bounds.area())) {
+            pairs.push_back({node1.first, index2});
+            pairs.push_back({node1.first + 1, index2});
+        } else {
+            pairs.push_back({index1, node2.first});
+            pairs.push_back({index1, node2.first + 1});
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check if the hierarchy collides with an octree.
+ *
+ * Same traversal as for two hierarchies; octree leaves are tested through
+ * their SIMD packs, and so are the straddlers of loose octree nodes.
+ *
+ * @param octree tree to check against
+ * @return true if any pair of triangles intersects
+ */
+bool Bvh::collides(OctreeNode* octree) const {
+    if (this->_nodes.empty()) return false;
+
+    std::vector<std::pair<uint32_t, OctreeNode*>> pairs = {{0, octree}};
+
+    while (!pairs.empty()) {
+        auto [index, tree] = pairs.back();
+        pairs.pop_back();
+
+        const Node& node = this->_nodes[index];
+        const AABB tree_bounds = to_AABB(tree->bounds());
+
+        if (!node.bounds.overlaps(tree_bounds)) continue;
+
+        const bool tree_leaf = !tree->has_children();
+
+        if (node.is_leaf() && tree_leaf) {
+            if (this->_leaf_intersects(node, tree->packs())) return true;
+        } else if (tree_leaf ||
+                   (!node.is_leaf() &&
+                    node.bounds.area() >= tree_bounds.area())) {
+            pairs.push_back({node.first, tree});
+            pairs.push_back({node.first + 1, tree});
+        } else {
+            for (OctreeNode* child : tree->children())
+                if (child) pairs.push_back({index, child});
+            if (OctreeNode* straddlers = tree->straddlers())
+                pairs.push_back({index, straddlers});
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Expected cost of a query against the hierarchy.
+ *
+ * Sum of the traversal cost of inner nodes and the intersection cost of
+ * leaves, each weighted by the probability of hitting the node (its surface
+ * area relative to the root). Lower is better; comparable across meshes.
+ *
+ * @return double SAH cost
+ */
+double Bvh::sah_cost() const {
+    if (this->_nodes.empty()) return 0;
+
+    const double root_area = this->_nodes[0].bounds.area();
+    if (root_area <= 0) return SAH_INTERSECTION_COST * this->_mesh->size();
+
+    double cost = 0;
+    for (const Node& node : this->_nodes) {
+        const double probability = node.bounds.area() / root_area;
+
+        if (node.is_leaf())
+            cost += probability * SAH_INTERSECTION_COST * node.count;
+        else
+            cost += probability * SAH_TRAVERSAL_COST;
+    }
+
+    return cost;
+}
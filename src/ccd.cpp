@@ -0,0 +1,463 @@
+#include "../include/ccd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "../include/common.hpp"
+#include "../include/partition.hpp"
+#include "../include/transform.hpp"
+
+using namespace YAAACD;
+
+/* TIME OF IMPACT
+ * Vertices move on straight lines over the time step. Two triangles first
+ * touch either when a vertex of one crosses the face of the other or when
+ * an edge of one crosses an edge of the other. Either way the four points
+ * involved become coplanar, which happens at a root of a cubic polynomial
+ * in t (Provot, Collision and self-collision handling in cloth model
+ * dedicated to design garments, 1997). Roots are then checked in increasing
+ * order for an actual contact.
+ *
+ * Points that stay coplanar over the whole step zero the cubic everywhere.
+ * Their contacts then start where a vertex meets the line of an edge, at
+ * the roots of the quadratic cross product of the three points involved.
+ */
+
+typedef std::array<double, 3> Vector;
+
+static Vector vector(const Vertex& vertex) {
+    return {vertex.x, vertex.y, vertex.z};
+}
+
+static Vector operator-(const Vector& lhs, const Vector& rhs) {
+    return {lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2]};
+}
+
+static Vector operator+(const Vector& lhs, const Vector& rhs) {
+    return {lhs[0] + rhs[0], lhs[1] + rhs[1], lhs[2] + rhs[2]};
+}
+
+static Vector operator*(double scale, const Vector& vector) {
+    return {scale * vector[0], scale * vector[1], scale * vector[2]};
+}
+
+static double dot(const Vector& lhs, const Vector& rhs) {
+    return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+}
+
+static Vector cross(const Vector& lhs, const Vector& rhs) {
+    return {
+        lhs[1] * rhs[2] - lhs[2] * rhs[1],
+        lhs[2] * rhs[0] - lhs[0] * rhs[2],
+        lhs[0] * rhs[1] - lhs[1] * rhs[0]
+    };
+}
+
+/**
+ * @brief Point moving from `start` at t = 0 to `start + velocity` at t = 1.
+ */
+struct Trajectory {
+    Vector start;
+    Vector velocity;
+
+    Trajectory(const Vertex& start, const Vertex& end)
+        : start(vector(start)), velocity(vector(end) - vector(start)) {}
+
+    Vector at(double t) const {
+        return this->start + t * this->velocity;
+    }
+};
+
+/**
+ * @brief Coefficients c0 + c1 t + c2 t^2 + c3 t^3 of the volume spanned by
+ * four moving points, zero whenever they are coplanar.
+ */
+static std::array<double, 4> coplanarity(
+    const std::array<const Trajectory*, 4>& points
+) {
+    const Vector b0 = points[1]->start - points[0]->start;
+    const Vector bd = points[1]->velocity - points[0]->velocity;
+    const Vector c0 = points[2]->start - points[0]->start;
+    const Vector cd = points[2]->velocity - points[0]->velocity;
+    const Vector p0 = points[3]->start - points[0]->start;
+    const Vector pd = points[3]->velocity - points[0]->velocity;
+
+    const Vector q0 = cross(b0, c0);
+    const Vector q1 = cross(b0, cd) + cross(bd, c0);
+    const Vector q2 = cross(bd, cd);
+
+    return {
+        dot(q0, p0),
+        dot(q0, pd) + dot(q1, p0),
+        dot(q1, pd) + dot(q2, p0),
+        dot(q2, pd)
+    };
+}
+
+/**
+ * @brief Check if four moving points stay coplanar over the whole step, up
+ * to the rounding of their coplanarity cubic.
+ *
+ * @param points the moving points
+ * @param c coefficients of their coplanarity cubic
+ * @return true if every coefficient is negligible next to the cube of the
+ * largest offset or relative velocity of the points
+ */
+static bool always_coplanar(
+    const std::array<const Trajectory*, 4>& points,
+    const std::array<double, 4>& c
+) {
+    double spread = 0;
+    for (int i = 1; i < 4; i++) {
+        const Vector offset = points[i]->start - points[0]->start;
+        const Vector velocity = points[i]->velocity - points[0]->velocity;
+        spread = std::max(
+            {spread,
+             std::sqrt(dot(offset, offset)),
+             std::sqrt(dot(velocity, velocity))}
+        );
+    }
+
+    const double tolerance = CCD_EPSILON * spread * spread * spread;
+    return std::all_of(c.begin(), c.end(), [tolerance](double coefficient) {
+        return std::fabs(coefficient) <= tolerance;
+    });
+}
+
+/**
+ * @brief Coefficients c0 + c1 t + c2 t^2 of one coordinate of the cross
+ * product of b - a and p - a, for three moving points. The coordinate with
+ * the largest coefficient is picked: the points are collinear only where
+ * every coordinate is zero, so its roots include all such times.
+ */
+static std::array<double, 4> collinearity(
+    const Trajectory& a,
+    const Trajectory& b,
+    const Trajectory& p
+) {
+    const Vector e0 = b.start - a.start, ed = b.velocity - a.velocity;
+    const Vector f0 = p.start - a.start, fd = p.velocity - a.velocity;
+
+    const Vector w0 = cross(e0, f0);
+    const Vector w1 = cross(e0, fd) + cross(ed, f0);
+    const Vector w2 = cross(ed, fd);
+
+    int axis = 0;
+    double largest = -1;
+    for (int k = 0; k < 3; k++) {
+        const double size =
+            std::max({std::fabs(w0[k]), std::fabs(w1[k]), std::fabs(w2[k])});
+        if (size > largest) {
+            largest = size;
+            axis = k;
+        }
+    }
+
+    return {w0[axis], w1[axis], w2[axis], 0};
+}
+
+static double evaluate(const std::array<double, 4>& c, double t) {
+    return ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+}
+
+/**
+ * @brief Roots of a cubic in [0, 1], in increasing order.
+ *
+ * [0, 1] is cut at the roots of the derivative into intervals where the
+ * cubic is monotonic, and every interval whose ends differ in sign is
+ * bisected down to the resolution of a double. Roots where the cubic only
+ * touches zero are missed; they are grazing contacts. A cubic that is zero
+ * everywhere yields the ends of the intervals as candidates; see
+ * always_coplanar() for the contacts in between.
+ *
+ * @param c coefficients, constant term first
+ * @param roots receives up to 4 roots
+ * @return int number of roots
+ */
+static int cubic_roots(const std::array<double, 4>& c, double roots[4]) {
+    double cuts[4] = {0, 1, 1, 1};
+    int count = 1;
+
+    // Critical points: 3 c3 t^2 + 2 c2 t + c1 = 0.
+    const double a = 3 * c[3], b = 2 * c[2];
+    if (a != 0) {
+        const double discriminant = b * b - 4 * a * c[1];
+        if (discriminant >= 0) {
+            const double root = std::sqrt(discriminant);
+            const double q = -0.5 * (b + std::copysign(root, b));
+            double t1 = q / a;
+            double t2 = q != 0 ? c[1] / q : t1;
+            if (t1 > t2) std::swap(t1, t2);
+
+            if (t1 > 0 && t1 < 1) cuts[count++] = t1;
+            if (t2 > 0 && t2 < 1 && t2 != t1) cuts[count++] = t2;
+        }
+    } else if (b != 0) {
+        const double t = -c[1] / b;
+        if (t > 0 && t < 1) cuts[count++] = t;
+    }
+    cuts[count++] = 1;
+
+    int found = 0;
+    if (evaluate(c, 0) == 0) roots[found++] = 0;
+
+    for (int i = 0; i + 1 < count; i++) {
+        double low = cuts[i], high = cuts[i + 1];
+        const double value_low = evaluate(c, low);
+        const double value_high = evaluate(c, high);
+
+        if (value_high == 0) {
+            if (high > 0) roots[found++] = high;
+            continue;
+        }
+        if (value_low == 0 || (value_low < 0) == (value_high < 0)) continue;
+
+        const bool rising = value_low < 0;
+        for (;;) {
+            const double middle = low + (high - low) / 2;
+            if (middle <= low || middle >= high) break;
+
+            if ((evaluate(c, middle) < 0) == rising)
+                low = middle;
+            else
+                high = middle;
+        }
+        roots[found++] = high;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Check if a point lies on a triangle, all four being coplanar.
+ */
+static bool vertex_on_face(
+    const Vector& p,
+    const Vector& a,
+    const Vector& b,
+    const Vector& c
+) {
+    const Vector v0 = b - a, v1 = c - a, v2 = p - a;
+    const double d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+    const double d20 = dot(v2, v0), d21 = dot(v2, v1);
+
+    const double denominator = d00 * d11 - d01 * d01;
+    if (!(denominator > 0)) return false;
+
+    const double v = (d11 * d20 - d01 * d21) / denominator;
+    const double w = (d00 * d21 - d01 * d20) / denominator;
+
+    return v >= -CCD_EPSILON && w >= -CCD_EPSILON &&
+           v + w <= 1 + CCD_EPSILON;
+}
+
+/**
+ * @brief Check if two coplanar segments cross. Parallel segments are left
+ * to the vertex-face tests, which see their endpoints.
+ */
+static bool edges_cross(
+    const Vector& p1,
+    const Vector& q1,
+    const Vector& p2,
+    const Vector& q2
+) {
+    const Vector d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    const double a = dot(d1, d1), e = dot(d2, d2), b = dot(d1, d2);
+    const double c = dot(d1, r), f = dot(d2, r);
+
+    const double denominator = a * e - b * b;
+    if (!(denominator > CCD_EPSILON * a * e)) return false;
+
+    const double s = (b * f - c * e) / denominator;
+    const double u = (b * s + f) / e;
+
+    return s >= -CCD_EPSILON && s <= 1 + CCD_EPSILON && u >= -CCD_EPSILON &&
+           u <= 1 + CCD_EPSILON;
+}
+
+/**
+ * @brief AABB of a box after a rigid transformation.
+ *
+ * The box is padded by the rounding error of the transformation, so that
+ * it contains the transformed vertices of every triangle it contained.
+ *
+ * @param box box to transform
+ * @param transform transformation to apply
+ * @return AABB bounds of the transformed box
+ */
+AABB YAAACD::helpers::transformed_box(
+    const BoundingBox& box,
+    const Transform& transform
+) {
+    AABB result;
+    double magnitude = 1;
+    for (const Vertex& corner : box.corners()) {
+        const Vertex point = transform.apply(corner);
+        result.extend(AABB({point, point, point}));
+        magnitude = std::max(
+            {magnitude,
+             std::fabs(point.x),
+             std::fabs(point.y),
+             std::fabs(point.z)}
+        );
+    }
+
+    const double margin = CCD_EPSILON * magnitude;
+    result.lower = Vertex(
+        result.lower.x - margin,
+        result.lower.y - margin,
+        result.lower.z - margin
+    );
+    result.upper = Vertex(
+        result.upper.x + margin,
+        result.upper.y + margin,
+        result.upper.z + margin
+    );
+
+    return result;
+}
+
+/**
+ * @brief Find when a moving box first overlaps a fixed one.
+ *
+ * A point moving linearly from inside `start` to inside `end` stays inside
+ * the box whose corners move linearly the same way, so the overlap of that
+ * box with `fixed` bounds every contact of what the boxes enclose.
+ *
+ * @param fixed box that does not move
+ * @param start moving box at time 0
+ * @param end moving box at time 1
+ * @param limit only overlaps starting before this time are looked for
+ * @param enter set to the time the boxes start to overlap
+ * @return true if the boxes overlap at some time in [0, 1] before `limit`
+ */
+bool YAAACD::helpers::sweep_overlap(
+    const AABB& fixed,
+    const AABB& start,
+    const AABB& end,
+    double limit,
+    double& enter
+) {
+    double exit = 1;
+    enter = 0;
+
+    // Keeps the times where value + slope * t >= 0.
+    auto constrain = [&enter, &exit](double value, double slope) {
+        if (slope > 0)
+            enter = std::max(enter, -value / slope);
+        else if (slope < 0)
+            exit = std::min(exit, -value / slope);
+        else if (value < 0)
+            exit = -1;
+    };
+
+    const Vector lower = vector(fixed.lower), upper = vector(fixed.upper);
+    const Vector lower0 = vector(start.lower), upper0 = vector(start.upper);
+    const Vector lower1 = vector(end.lower), upper1 = vector(end.upper);
+
+    for (int axis = 0; axis < 3; axis++) {
+        constrain(upper0[axis] - lower[axis], upper1[axis] - upper0[axis]);
+        constrain(upper[axis] - lower0[axis], lower0[axis] - lower1[axis]);
+    }
+
+    return enter <= exit && enter < limit;
+}
+
+/**
+ * @brief Earliest time two moving triangles touch.
+ *
+ * Triangles intersecting at time 0 touch at 0. Otherwise the 6 vertex-face
+ * and 9 edge-edge pairs are tested and the earliest contact is kept. Roots
+ * are always searched in the whole step, so the time found for a pair does
+ * not depend on `limit`.
+ *
+ * @param start1 first triangle at time 0
+ * @param end1 first triangle at time 1
+ * @param start2 second triangle at time 0
+ * @param end2 second triangle at time 1
+ * @param limit only contacts before this time are looked for
+ * @return double time of the first contact, infinity if there is none
+ * before `limit`
+ */
+double YAAACD::helpers::triangles_impact(
+    const Triangle& start1,
+    const Triangle& end1,
+    const Triangle& start2,
+    const Triangle& end2,
+    double limit
+) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    if (limit > 0 && triangles_intersect(start1, start2)) return 0;
+
+    const std::array<Trajectory, 6> points = {
+        Trajectory(start1[0], end1[0]),
+        Trajectory(start1[1], end1[1]),
+        Trajectory(start1[2], end1[2]),
+        Trajectory(start2[0], end2[0]),
+        Trajectory(start2[1], end2[1]),
+        Trajectory(start2[2], end2[2])
+    };
+
+    double best = limit;
+    auto test = [&points, &best](const std::array<int, 4>& ids, bool edges) {
+        const std::array<const Trajectory*, 4> moving = {
+            &points[ids[0]],
+            &points[ids[1]],
+            &points[ids[2]],
+            &points[ids[3]]
+        };
+
+        // Coplanar points: each vertex against the line of each edge.
+        constexpr int face_lines[3][3] = {{0, 1, 3}, {1, 2, 3}, {2, 0, 3}};
+        constexpr int edge_lines[4][3] = {
+            {0, 1, 2},
+            {0, 1, 3},
+            {2, 3, 0},
+            {2, 3, 1}
+        };
+
+        double roots[4 + 4 * 4];
+        const std::array<double, 4> volume = coplanarity(moving);
+        int count = cubic_roots(volume, roots);
+        if (always_coplanar(moving, volume)) {
+            const int lines = edges ? 4 : 3;
+            for (int line = 0; line < lines; line++) {
+                const int* triple =
+                    edges ? edge_lines[line] : face_lines[line];
+                const std::array<double, 4> quadratic = collinearity(
+                    *moving[triple[0]],
+                    *moving[triple[1]],
+                    *moving[triple[2]]
+                );
+                count += cubic_roots(quadratic, roots + count);
+            }
+            std::sort(roots, roots + count);
+        }
+
+        for (int i = 0; i < count && roots[i] < best; i++) {
+            const double t = roots[i];
+            const Vector a = moving[0]->at(t), b = moving[1]->at(t);
+            const Vector c = moving[2]->at(t), d = moving[3]->at(t);
+
+            if (edges ? edges_cross(a, b, c, d) : vertex_on_face(d, a, b, c)) {
+                best = t;
+                return;
+            }
+        }
+    };
+
+    for (int face = 0; face < 2; face++)
+        for (int vertex = 0; vertex < 3; vertex++) {
+            const int f = 3 * face, v = 3 * (1 - face) + vertex;
+            test({f, f + 1, f + 2, v}, false);
+        }
+
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            test({i, (i + 1) % 3, 3 + j, 3 + (j + 1) % 3}, true);
+
+    return best < limit ? best : inf;
+}
@@ -0,0 +1,192 @@
+#include "../include/contacts.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "../include/common.hpp"
+
+using namespace YAAACD;
+
+/**
+ * @brief Construct a new ContactSink object.
+ *
+ * @param callback callback receiving the contacts
+ * @param query limits of the query
+ */
+ContactSink::ContactSink(
+    const ContactCallback& callback,
+    const ContactQuery& query
+)
+    : _callback(callback), _query(query), _stopped(query.max_contacts == 0) {}
+
+/**
+ * @brief Report a pair of intersecting triangles.
+ *
+ * @param first id of the triangle of the queried object
+ * @param second id of the triangle of the other object
+ * @param triangle1 triangle `first`
+ * @param triangle2 triangle `second`
+ * @return true if the query should go on
+ */
+bool ContactSink::report(
+    uint32_t first,
+    uint32_t second,
+    const Triangle& triangle1,
+    const Triangle& triangle2
+) {
+    if (this->_stopped) return false;
+
+    Contact contact;
+    contact.first = first;
+    contact.second = second;
+    if (this->_query.segments)
+        contact.has_segment = helpers::intersection_segment(
+            triangle1,
+            triangle2,
+            contact.start,
+            contact.end
+        );
+
+    this->_count++;
+    if (!this->_callback(contact) || this->_count >= this->_query.max_contacts)
+        this->_stopped = true;
+
+    return !this->_stopped;
+}
+
+static std::array<double, 3> difference(const Vertex& lhs, const Vertex& rhs) {
+    return {lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+}
+
+static std::array<double, 3> cross(
+    const std::array<double, 3>& lhs,
+    const std::array<double, 3>& rhs
+) {
+    return {
+        lhs[1] * rhs[2] - lhs[2] * rhs[1],
+        lhs[2] * rhs[0] - lhs[0] * rhs[2],
+        lhs[0] * rhs[1] - lhs[1] * rhs[0]
+    };
+}
+
+static double dot(const std::array<double, 3>& lhs, const Vertex& rhs) {
+    return lhs[0] * rhs.x + lhs[1] * rhs.y + lhs[2] * rhs.z;
+}
+
+/**
+ * @brief Clip a triangle against the plane of another one.
+ *
+ * @param triangle triangle to clip
+ * @param normal normal of the plane
+ * @param offset offset of the plane (dot(normal, x) = offset)
+ * @param direction direction of the intersection line of both planes
+ * @param lower set to the point of the crossing with the lowest projection
+ * on `direction`
+ * @param upper set to the point with the highest projection
+ * @return false if the triangle does not reach the plane
+ */
+static bool clip_to_plane(
+    const Triangle& triangle,
+    const std::array<double, 3>& normal,
+    double offset,
+    const std::array<double, 3>& direction,
+    Vertex& lower,
+    Vertex& upper
+) {
+    std::array<double, 3> distances;
+    for (int k = 0; k < 3; k++)
+        distances[k] = dot(normal, triangle[k]) - offset;
+
+    bool found = false;
+    double lowest = 0;
+    double highest = 0;
+    auto add = [&](const Vertex& point) {
+        const double position = dot(direction, point);
+        if (!found || position < lowest) {
+            lowest = position;
+            lower = point;
+        }
+        if (!found || position > highest) {
+            highest = position;
+            upper = point;
+        }
+        found = true;
+    };
+
+    for (int k = 0; k < 3; k++) {
+        const Vertex& a = triangle[k];
+        const Vertex& b = triangle[(k + 1) % 3];
+        const double da = distances[k];
+        const double db = distances[(k + 1) % 3];
+
+        if (da == 0) add(a);
+        if ((da < 0 && db > 0) || (da > 0 && db < 0)) {
+            const double t = da / (da - db);
+            add(Vertex(
+                a.x + t * (b.x - a.x),
+                a.y + t * (b.y - a.y),
+                a.z + t * (b.z - a.z)
+            ));
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Compute the segment along which two intersecting triangles cross.
+ *
+ * Each triangle is clipped against the plane of the other; both pieces lie
+ * on the intersection line of the planes, and the segment is the overlap of
+ * the two. Coplanar triangles overlap in an area rather than a segment, so
+ * no segment is computed for them.
+ *
+ * @param triangle1 first triangle
+ * @param triangle2 second triangle, known to intersect the first
+ * @param start set to the first end of the segment
+ * @param end set to the second end of the segment
+ * @return true if a segment was computed
+ */
+bool YAAACD::helpers::intersection_segment(
+    const Triangle& triangle1,
+    const Triangle& triangle2,
+    Vertex& start,
+    Vertex& end
+) {
+    const std::array<double, 3> normal1 = cross(
+        difference(triangle1[1], triangle1[0]),
+        difference(triangle1[2], triangle1[0])
+    );
+    const std::array<double, 3> normal2 = cross(
+        difference(triangle2[1], triangle2[0]),
+        difference(triangle2[2], triangle2[0])
+    );
+    const std::array<double, 3> direction = cross(normal1, normal2);
+    if (direction[0] == 0 && direction[1] == 0 && direction[2] == 0)
+        return false;
+
+    Vertex lower1, upper1, lower2, upper2;
+    if (!clip_to_plane(
+            triangle1,
+            normal2,
+            dot(normal2, triangle2[0]),
+            direction,
+            lower1,
+            upper1
+        ) ||
+        !clip_to_plane(
+            triangle2,
+            normal1,
+            dot(normal1, triangle1[0]),
+            direction,
+            lower2,
+            upper2
+        ))
+        return false;
+
+    start = dot(direction, lower1) > dot(direction, lower2) ? lower1 : lower2;
+    end = dot(direction, upper1) < dot(direction, upper2) ? upper1 : upper2;
+
+    return true;
+}
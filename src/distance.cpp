@@ -0,0 +1,237 @@
+#include "../include/distance.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "../include/common.hpp"
+#include "../include/contacts.hpp"
+
+using namespace YAAACD;
+
+/* CLOSEST POINTS
+ * The distance between two disjoint triangles is reached either between a
+ * vertex of one and the other triangle, or between two edges. The routines
+ * below follow Ericson, Real-Time Collision Detection, 5.1.5 and 5.1.9.
+ */
+
+typedef std::array<double, 3> Vector;
+
+static Vector vector(const Vertex& vertex) {
+    return {vertex.x, vertex.y, vertex.z};
+}
+
+static Vector operator-(const Vector& lhs, const Vector& rhs) {
+    return {lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2]};
+}
+
+static Vector operator+(const Vector& lhs, const Vector& rhs) {
+    return {lhs[0] + rhs[0], lhs[1] + rhs[1], lhs[2] + rhs[2]};
+}
+
+static Vector operator*(double scale, const Vector& vector) {
+    return {scale * vector[0], scale * vector[1], scale * vector[2]};
+}
+
+static double dot(const Vector& lhs, const Vector& rhs) {
+    return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+}
+
+static Vertex vertex(const Vector& vector) {
+    return Vertex(vector[0], vector[1], vector[2]);
+}
+
+/**
+ * @brief Closest point of the triangle (a, b, c) to p, found by locating p
+ * in the Voronoi regions of the triangle's features.
+ */
+static Vector closest_on_triangle(
+    const Vector& p,
+    const Vector& a,
+    const Vector& b,
+    const Vector& c
+) {
+    const Vector ab = b - a;
+    const Vector ac = c - a;
+
+    const Vector ap = p - a;
+    const double d1 = dot(ab, ap);
+    const double d2 = dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0) return a;
+
+    const Vector bp = p - b;
+    const double d3 = dot(ab, bp);
+    const double d4 = dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3) return b;
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + (d1 / (d1 - d3)) * ab;
+
+    const Vector cp = p - c;
+    const double d5 = dot(ab, cp);
+    const double d6 = dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6) return c;
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + (d2 / (d2 - d6)) * ac;
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+        return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+
+    const double denominator = 1 / (va + vb + vc);
+    return a + (vb * denominator) * ab + (vc * denominator) * ac;
+}
+
+/**
+ * @brief Closest points of the segments [p1, q1] and [p2, q2].
+ */
+static void closest_on_segments(
+    const Vector& p1,
+    const Vector& q1,
+    const Vector& p2,
+    const Vector& q2,
+    Vector& closest1,
+    Vector& closest2
+) {
+    const Vector d1 = q1 - p1;
+    const Vector d2 = q2 - p2;
+    const Vector r = p1 - p2;
+    const double a = dot(d1, d1);
+    const double e = dot(d2, d2);
+    const double f = dot(d2, r);
+
+    double s = 0;
+    double t = 0;
+    if (a == 0 && e == 0) {
+        // Both segments are points.
+    } else if (a == 0) {
+        t = std::clamp(f / e, 0.0, 1.0);
+    } else {
+        const double c = dot(d1, r);
+        if (e == 0) {
+            s = std::clamp(-c / a, 0.0, 1.0);
+        } else {
+            const double b = dot(d1, d2);
+            const double denominator = a * e - b * b;
+
+            if (denominator != 0)
+                s = std::clamp((b * f - c * e) / denominator, 0.0, 1.0);
+            t = (b * s + f) / e;
+
+            if (t < 0) {
+                t = 0;
+                s = std::clamp(-c / a, 0.0, 1.0);
+            } else if (t > 1) {
+                t = 1;
+                s = std::clamp((b - c) / a, 0.0, 1.0);
+            }
+        }
+    }
+
+    closest1 = p1 + s * d1;
+    closest2 = p2 + t * d2;
+}
+
+/**
+ * @brief Squared distance between two boxes, 0 if they overlap.
+ *
+ * @param box1 first box
+ * @param box2 second box
+ * @return double squared length of the shortest segment joining the boxes
+ */
+double YAAACD::helpers::box_distance_squared(
+    const BoundingBox& box1,
+    const BoundingBox& box2
+) {
+    const double gaps[3] = {
+        std::max(
+            {0.0,
+             box2.lower().x - box1.upper().x,
+             box1.lower().x - box2.upper().x}
+        ),
+        std::max(
+            {0.0,
+             box2.lower().y - box1.upper().y,
+             box1.lower().y - box2.upper().y}
+        ),
+        std::max(
+            {0.0,
+             box2.lower().z - box1.upper().z,
+             box1.lower().z - box2.upper().z}
+        ),
+    };
+
+    return gaps[0] * gaps[0] + gaps[1] * gaps[1] + gaps[2] * gaps[2];
+}
+
+/**
+ * @brief Squared distance between two triangles and the points realizing
+ * it.
+ *
+ * Intersecting triangles are at distance 0; their closest points are then a
+ * point of the intersection.
+ *
+ * @param triangle1 first triangle
+ * @param triangle2 second triangle
+ * @param point1 set to the closest point on the first triangle
+ * @param point2 set to the closest point on the second triangle
+ * @return double squared distance
+ */
+double YAAACD::helpers::triangle_distance_squared(
+    const Triangle& triangle1,
+    const Triangle& triangle2,
+    Vertex& point1,
+    Vertex& point2
+) {
+    if (triangles_intersect(triangle1, triangle2) &&
+        intersection_segment(triangle1, triangle2, point1, point2)) {
+        point2 = point1;
+        return 0;
+    }
+
+    // Coplanar overlaps come out at distance 0 below, through a vertex
+    // inside the other triangle or two crossing edges.
+    const std::array<Vector, 3> a = {
+        vector(triangle1[0]),
+        vector(triangle1[1]),
+        vector(triangle1[2])
+    };
+    const std::array<Vector, 3> b = {
+        vector(triangle2[0]),
+        vector(triangle2[1]),
+        vector(triangle2[2])
+    };
+
+    double best = std::numeric_limits<double>::infinity();
+    auto consider = [&](const Vector& closest1, const Vector& closest2) {
+        const Vector difference = closest1 - closest2;
+        const double distance = dot(difference, difference);
+        if (distance < best) {
+            best = distance;
+            point1 = vertex(closest1);
+            point2 = vertex(closest2);
+        }
+    };
+
+    for (int k = 0; k < 3; k++) {
+        consider(a[k], closest_on_triangle(a[k], b[0], b[1], b[2]));
+        consider(closest_on_triangle(b[k], a[0], a[1], a[2]), b[k]);
+    }
+
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) {
+            Vector closest1, closest2;
+            closest_on_segments(
+                a[i],
+                a[(i + 1) % 3],
+                b[j],
+                b[(j + 1) % 3],
+                closest1,
+                closest2
+            );
+            consider(closest1, closest2);
+        }
+
+    return best;
+}
@@ -1,87 +1,441 @@
 #include "../include/hashmap.hpp"
 
-#include <CGAL/intersections.h>
-
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "../include/common.hpp"
+#include "../include/contacts.hpp"
+#include "../include/mesh.hpp"
+#include "../include/partition.hpp"
+#include "../include/stats.hpp"
+#include "../include/trace.hpp"
 
 using namespace YAAACD;
 
+// Cell coordinates are clamped to this range, so that converting them is
+// defined and loops over a range of cells can step past the last one.
+constexpr double CELL_LIMIT = std::numeric_limits<int32_t>::max() - 1;
+// Cell sizes are coarsened until no triangle spans more than this many cells
+// along an axis, which bounds the cells registered per triangle.
+constexpr double MAX_TRIANGLE_CELLS = 32;
+// Cell ids and the CSR offsets are 32 bits wide, which bounds the number of
+// (cell, triangle) pairs a map can hold.
+constexpr size_t MAX_CELL_PAIRS = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Construct a table with room for the given number of cells.
+ *
+ * The capacity is a power of two at least twice the number of cells, which
+ * keeps probe sequences short. Inserting more cells doubles it as needed.
+ *
+ * @param cells number of cells the table is sized for
+ */
+CellTable::CellTable(size_t cells) {
+    this->_slots.resize(std::bit_ceil(std::max<size_t>(2 * cells, 16)));
+}
+
+size_t CellTable::_slot(const Cell& cell) const {
+    uint64_t hash = static_cast<uint32_t>(cell.x) * 0x9E3779B97F4A7C15ull ^
+                    static_cast<uint32_t>(cell.y) * 0xC2B2AE3D27D4EB4Full ^
+                    static_cast<uint32_t>(cell.z) * 0x165667B19E3779F9ull;
+    hash ^= hash >> 32;
+
+    return hash & (this->_slots.size() - 1);
+}
+
+/**
+ * @brief Double the capacity and reinsert every cell under its id.
+ */
+void CellTable::_grow() {
+    std::vector<Slot> slots(2 * this->_slots.size());
+    std::swap(slots, this->_slots);
+
+    const size_t mask = this->_slots.size() - 1;
+    for (const Slot& entry : slots) {
+        if (entry.id == EMPTY_CELL) continue;
+
+        size_t slot = this->_slot(entry.key);
+        while (this->_slots[slot].id != EMPTY_CELL) slot = (slot + 1) & mask;
+        this->_slots[slot] = entry;
+    }
+}
+
+/**
+ * @brief Return the id of a cell, inserting it if needed.
+ *
+ * @param cell cell to insert
+ * @return uint32_t id of the cell
+ */
+uint32_t CellTable::insert(const Cell& cell) {
+    if (2 * (static_cast<size_t>(this->_size) + 1) > this->_slots.size())
+        this->_grow();
+    const size_t mask = this->_slots.size() - 1;
+
+    for (size_t slot = this->_slot(cell);; slot = (slot + 1) & mask) {
+        Slot& entry = this->_slots[slot];
+
+        if (entry.id == EMPTY_CELL) {
+            entry.key = cell;
+            entry.id = this->_size++;
+            return entry.id;
+        }
+        if (entry.key == cell) return entry.id;
+    }
+}
+
+/**
+ * @brief Return the id of a cell.
+ *
+ * @param cell cell to look up
+ * @return uint32_t id of the cell, EMPTY_CELL if it was never inserted
+ */
+uint32_t CellTable::find(const Cell& cell) const {
+    const size_t mask = this->_slots.size() - 1;
+
+    for (size_t slot = this->_slot(cell);; slot = (slot + 1) & mask) {
+        const Slot& entry = this->_slots[slot];
+
+        if (entry.id == EMPTY_CELL) return EMPTY_CELL;
+        if (entry.key == cell) return entry.id;
+    }
+}
+
+/**
+ * @brief Number of cells from `lower` to `upper` along an axis, computed in
+ * 64 bits since clamped coordinates can be 2^32 cells apart.
+ */
+static size_t cell_span(int32_t lower, int32_t upper) {
+    return static_cast<size_t>(static_cast<int64_t>(upper) - lower + 1);
+}
+
+/**
+ * @brief Construct a new SpatialHashMap object.
+ *
+ * @param mesh mesh to store, can be shared with other engines
+ * @param levels subdivision depth; also sets the default cell size to the
+ * size of a box subdivided `levels` times
+ * @param cell_size edge of a grid cell, 0 to derive it from `levels`;
+ * derived sizes smaller than 1 / MAX_TRIANGLE_CELLS of the largest triangle
+ * are coarsened to that, explicit ones are kept
+ * @param table_size number of cells to size the cell table for, 0 to size
+ * it for every (cell, triangle) pair so that it never grows; smaller tables
+ * save memory on meshes whose triangles share most of their cells
+ * @throw std::length_error if the triangles overlap more than
+ * MAX_CELL_PAIRS cells in total
+ */
 SpatialHashMap::SpatialHashMap(
-    const std::vector<Triangle>& triangles,
-    int levels
+    std::shared_ptr<const IndexedMesh> mesh,
+    int levels,
+    double cell_size,
+    size_t table_size
 ) {
-    this->_levels = levels;
-    std::vector<Vertex> vertices;
+    YAAACD_TRACE_SPAN("SpatialHashMap::build");
+    this->_mesh = std::move(mesh);
+    this->_bounds = triangle_bounds(*this->_mesh);
 
-    for (const Triangle& triangle : triangles)
-        std::for_each(
-            triangle.begin(),
-            triangle.end(),
-            [&vertices](const Vertex& vertex) {
-                vertices.push_back(vertex);
-            }
+    const std::vector<AABB>& boxes = this->_bounds;
+    for (const AABB& box : boxes) this->_extent.extend(box);
+    const AABB& root = this->_extent;
+
+    if (cell_size <= 0) {
+        const double extent = std::max(
+            {root.upper.x - root.lower.x,
+             root.upper.y - root.lower.y,
+             root.upper.z - root.lower.z,
+             0.0}
         );
+        cell_size = extent > 0 ? std::ldexp(extent, -levels) : 1;
+
+        double largest = 0;
+        for (const AABB& box : boxes)
+            largest = std::max(
+                {largest,
+                 box.upper.x - box.lower.x,
+                 box.upper.y - box.lower.y,
+                 box.upper.z - box.lower.z}
+            );
+        cell_size = std::max(cell_size, largest / MAX_TRIANGLE_CELLS);
+    }
+    this->_cell_size = cell_size;
+    this->_lower = this->_cell(root.lower);
+    this->_upper = this->_cell(root.upper);
 
-    BoundingBox root(vertices);
-    std::vector<BoundingBox*> children = root.split(levels, triangles);
+    // The number of (cell, triangle) pairs bounds the number of cells, so
+    // a table sized for it never needs to grow. Counts are taken in double,
+    // a single clamped triangle can overlap 2^96 cells.
+    size_t pairs = 0;
+    for (const AABB& box : boxes) {
+        const Cell lower = this->_cell(box.lower);
+        const Cell upper = this->_cell(box.upper);
+        const double count = static_cast<double>(cell_span(lower.x, upper.x)) *
+                             cell_span(lower.y, upper.y) *
+                             cell_span(lower.z, upper.z);
+        if (count > MAX_CELL_PAIRS - pairs)
+            throw std::length_error(
+                "spatial hash map cells too small for the mesh"
+            );
+        pairs += static_cast<size_t>(count);
+    }
+    this->_table = CellTable(table_size ? table_size : pairs);
+
+    std::vector<uint32_t> cells;
+    std::vector<uint32_t> members;
+    cells.reserve(pairs);
+    members.reserve(pairs);
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+        const Cell lower = this->_cell(boxes[i].lower);
+        const Cell upper = this->_cell(boxes[i].upper);
+
+        for (int32_t x = lower.x; x <= upper.x; x++)
+            for (int32_t y = lower.y; y <= upper.y; y++)
+                for (int32_t z = lower.z; z <= upper.z; z++) {
+                    cells.push_back(this->_table.insert({x, y, z}));
+                    members.push_back(i);
+                }
+    }
 
-    std::for_each(children.begin(), children.end(), [&](BoundingBox* box) {
-        this->insert(box);
-    });
+    // Counting sort of the pairs by cell.
+    this->_offsets.assign(this->_table.size() + 1, 0);
+    for (uint32_t cell : cells) this->_offsets[cell + 1]++;
+    for (size_t i = 1; i < this->_offsets.size(); i++)
+        this->_offsets[i] += this->_offsets[i - 1];
+
+    std::vector<uint32_t> next(
+        this->_offsets.begin(),
+        this->_offsets.end() - 1
+    );
+    this->_indices.resize(pairs);
+    for (size_t i = 0; i < pairs; i++)
+        this->_indices[next[cells[i]]++] = members[i];
 }
 
-int SpatialHashMap::_hash(BoundingBox* box) {
-    Vertex center = box->center();
+/**
+ * @brief Construct a new SpatialHashMap object from a triangle soup.
+ *
+ * @param triangles triangles to store
+ * @param levels subdivision depth used for the default cell size
+ * @param cell_size edge of a grid cell, 0 to derive it from `levels`
+ * @param table_size number of cells to size the cell table for, 0 for one
+ * per (cell, triangle) pair
+ */
+SpatialHashMap::SpatialHashMap(
+    const std::vector<Triangle>& triangles,
+    int levels,
+    double cell_size,
+    size_t table_size
+)
+    : SpatialHashMap(
+          std::make_shared<const IndexedMesh>(triangles),
+          levels,
+          cell_size,
+          table_size
+      ) {}
+
+/**
+ * @brief Coordinate of the cell holding a coordinate, clamped to
+ * [-CELL_LIMIT, CELL_LIMIT]: far coordinates or tiny cells would not fit in
+ * an int32_t. Clamped cells merge the space beyond the limit, which only
+ * costs some candidate pairs.
+ *
+ * @param coordinate coordinate of a point along one axis
+ * @param cell_size edge of a grid cell
+ * @return int32_t cell coordinate
+ */
+static int32_t cell_coordinate(double coordinate, double cell_size) {
+    return static_cast<int32_t>(
+        std::clamp(std::floor(coordinate / cell_size), -CELL_LIMIT, CELL_LIMIT)
+    );
+}
 
-    return (static_cast<int>(center.x / CELL_SIZE * P1) ^
-            static_cast<int>(center.y / CELL_SIZE * P2) ^
-            static_cast<int>(center.z / CELL_SIZE * P3)) %
-           TABLE_SIZE;
+Cell SpatialHashMap::_cell(const Vertex& vertex) const {
+    return {
+        cell_coordinate(vertex.x, this->_cell_size),
+        cell_coordinate(vertex.y, this->_cell_size),
+        cell_coordinate(vertex.z, this->_cell_size)
+    };
 }
 
-void SpatialHashMap::insert(BoundingBox* box) {
-    int hash = this->_hash(box);
+/**
+ * @brief Call `visit` with every stored triangle whose AABB overlaps the
+ * AABB of a triangle, until it returns true.
+ *
+ * The triangle is mapped to the cells its AABB overlaps, clipped to the
+ * cells the stored mesh occupies, and compared with the triangles registered
+ * there. A pair sharing several cells is only visited in the cell containing
+ * the lower corner of the overlap of their AABBs, so every pair is visited
+ * at most once.
+ *
+ * @param triangle triangle to check
+ * @param visit callable taking the index of a stored triangle
+ * @param stats stats policy
+ * @return true if `visit` returned true
+ */
+template <typename Visitor, typename Stats>
+bool SpatialHashMap::_visit(
+    const Triangle& triangle,
+    Visitor visit,
+    Stats stats
+) const {
+    const AABB box(triangle);
+    if (!box.overlaps(this->_extent)) return false;
+
+    // A large triangle can cover far more cells than the mesh occupies.
+    const Cell first = this->_cell(box.lower);
+    const Cell last = this->_cell(box.upper);
+    const Cell lower = {
+        std::max(first.x, this->_lower.x),
+        std::max(first.y, this->_lower.y),
+        std::max(first.z, this->_lower.z)
+    };
+    const Cell upper = {
+        std::min(last.x, this->_upper.x),
+        std::min(last.y, this->_upper.y),
+        std::min(last.z, this->_upper.z)
+    };
+
+    for (int32_t x = lower.x; x <= upper.x; x++)
+        for (int32_t y = lower.y; y <= upper.y; y++)
+            for (int32_t z = lower.z; z <= upper.z; z++) {
+                const uint32_t cell = this->_table.find({x, y, z});
+                if (cell == EMPTY_CELL) continue;
+
+                stats.leaf_test();
+                for (uint32_t i = this->_offsets[cell];
+                     i < this->_offsets[cell + 1];
+                     i++) {
+                    const uint32_t index = this->_indices[i];
+                    const AABB& other = this->_bounds[index];
+                    stats.visit();
+                    stats.box_test();
+                    if (!box.overlaps(other)) {
+                        stats.prune();
+                        continue;
+                    }
 
-    if (!box->members().size()) return;
+                    const Cell reference = this->_cell(Vertex(
+                        std::max(box.lower.x, other.lower.x),
+                        std::max(box.lower.y, other.lower.y),
+                        std::max(box.lower.z, other.lower.z)
+                    ));
+                    if (!(reference == Cell{x, y, z})) {
+                        stats.prune();
+                        continue;
+                    }
+
+                    if (visit(index)) return true;
+                }
+            }
+
+    return false;
+}
 
-    std::map<int, std::vector<Triangle>>::iterator cell = this->_map.find(hash);
-    if (cell != this->_map.end()) {
-        std::copy(
-            box->members().begin(),
-            box->members().end(),
-            std::back_inserter(cell->second)
+/**
+ * @brief Check if a triangle intersects any stored triangle.
+ *
+ * @param triangle triangle to check
+ * @param stats stats policy
+ * @return true if the triangle intersects a stored triangle
+ */
+template <typename Stats>
+bool SpatialHashMap::_collides(const Triangle& triangle, Stats stats) const {
+    auto test = [this, &triangle, stats](uint32_t index) {
+        stats.triangle_tests(1);
+        [[maybe_unused]] const auto timer = stats.time(&QueryStats::leaf_ns);
+
+        return helpers::triangles_intersect(
+            triangle,
+            this->_mesh->triangle(index)
         );
-        return;
-    }
+    };
+
+    return this->_visit(triangle, test, stats);
+}
 
-    this->_map.insert_or_assign(hash, box->members());
+/**
+ * @brief Check if any triangle of a mesh intersects a stored triangle.
+ *
+ * @param mesh mesh to check
+ * @return true if any pair of triangles intersects
+ */
+bool SpatialHashMap::collides(const IndexedMesh& mesh) const {
+    YAAACD_TRACE_SPAN("SpatialHashMap::collides");
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        if (this->_collides(mesh.triangle(i), NoStats())) return true;
+
+    return false;
 }
 
-bool SpatialHashMap::collides(const std::vector<Triangle>& triangles) {
-    std::vector<Vertex> vertices;
+/**
+ * @brief Check if any triangle of a mesh intersects a stored triangle,
+ * recording what the query did.
+ *
+ * @param mesh mesh to check
+ * @param stats stats the counters and timings of the query are added to
+ * @return true if any pair of triangles intersects
+ */
+bool SpatialHashMap::collides(
+    const IndexedMesh& mesh,
+    QueryStats& stats
+) const {
+    YAAACD_TRACE_SPAN("SpatialHashMap::collides");
+    const RecordStats recorder(stats);
+    [[maybe_unused]] const auto timer =
+        recorder.time(&QueryStats::traversal_ns, &QueryStats::leaf_ns);
+
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        if (this->_collides(mesh.triangle(i), recorder)) return true;
+
+    return false;
+}
 
+/**
+ * @brief Check if any of the triangles intersects a stored triangle.
+ *
+ * @param triangles triangles to check
+ * @return true if any pair of triangles intersects
+ */
+bool SpatialHashMap::collides(const std::vector<Triangle>& triangles) const {
+    YAAACD_TRACE_SPAN("SpatialHashMap::collides");
     for (const Triangle& triangle : triangles)
-        std::for_each(
-            triangle.begin(),
-            triangle.end(),
-            [&vertices](const Vertex& vertex) {
-                vertices.push_back(vertex);
-            }
-        );
+        if (this->_collides(triangle, NoStats())) return true;
 
-    BoundingBox root(vertices);
-    std::vector<BoundingBox*> children = root.split(this->_levels, triangles);
+    return false;
+}
 
-    return std::any_of(children.begin(), children.end(), [&](BoundingBox* box) {
-        int hash = this->_hash(box);
+/**
+ * @brief Report every pair of a stored triangle and a triangle of a mesh
+ * that intersect. Each pair is reported once, from its reference cell.
+ *
+ * @param mesh mesh to check
+ * @param callback callback receiving the contacts, returning false to stop;
+ * `first` is the stored triangle and `second` the triangle of `mesh`
+ * @param query maximum number of contacts and whether to compute segments
+ * @return size_t number of contacts reported
+ */
+size_t SpatialHashMap::contacts(
+    const IndexedMesh& mesh,
+    const ContactCallback& callback,
+    const ContactQuery& query
+) const {
+    ContactSink sink(callback, query);
 
-        auto cell = this->_map.find(hash);
-        if (cell != this->_map.end()) {
-            return helpers::primes_intersect({cell->second, box->members()});
-        }
+    for (uint32_t i = 0; i < mesh.size() && !sink.stopped(); i++) {
+        const Triangle triangle = mesh.triangle(i);
+
+        this->_visit(triangle, [&](uint32_t index) {
+            const Triangle stored = this->_mesh->triangle(index);
+            if (!helpers::triangles_intersect(stored, triangle)) return false;
+
+            return !sink.report(index, i, stored, triangle);
+        });
+    }
 
-        return false;
-    });
+    return sink.count();
 }
@@ -2,6 +2,7 @@
 #include <CGAL/Point_3.h>
 
 #include "../include/common.hpp"
+#include "../include/packs.hpp"
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel CGALKernel;
 
@@ -36,15 +37,7 @@ const CGALKernel::Triangle_3 YAAACD::converters::to_Triangle_3(
 bool YAAACD::helpers::primes_intersect(
     const std::array<const std::vector<Triangle>, 2>& sets
 ) {
-    for (const auto& triangle1 : sets[0])
-        for (const auto& triangle2 : sets[1])
-            if (CGAL::intersection(
-                    converters::to_Triangle_3(triangle1),
-                    converters::to_Triangle_3(triangle2)
-                ))
-                return true;
-
-    return false;
+    return helpers::packs_intersect(sets[0], pack_triangles(sets[1]));
 }
 
 bool YAAACD::bruteforce_collides(
@@ -56,10 +49,7 @@ bool YAAACD::bruteforce_collides(
                 triangles2.begin(),
                 triangles2.end(),
                 [&triangle1](const Triangle& triangle) {
-                    return CGAL::intersection(
-                        converters::to_Triangle_3(triangle1),
-                        converters::to_Triangle_3(triangle)
-                    );
+                    return helpers::triangles_intersect(triangle1, triangle);
                 }
             ))
             return true;
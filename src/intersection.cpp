@@ -0,0 +1,341 @@
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+
+#include <cmath>
+#include <limits>
+
+#include "../include/common.hpp"
+
+typedef CGAL::Exact_predicates_inexact_constructions_kernel CGALKernel;
+
+using namespace YAAACD;
+
+/* FILTERED PREDICATES
+ * Both orientation predicates are first evaluated in plain floating point.
+ * The result is only trusted when the determinant exceeds a static bound on
+ * its rounding error (Shewchuk's first-stage bounds); otherwise the exact
+ * CGAL predicate decides. Near-degenerate configurations (touching vertices,
+ * shared edges, coplanar triangles) are the only ones that pay for exactness.
+ */
+
+constexpr double EPSILON = std::numeric_limits<double>::epsilon() / 2;
+constexpr double O3D_ERRBOUND = (7.0 + 56.0 * EPSILON) * EPSILON;
+constexpr double O2D_ERRBOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+
+/**
+ * @brief Sign of the orientation of d with respect to the plane (a, b, c).
+ *
+ * @return 1 if d is on the positive side, -1 if negative and 0 if coplanar
+ */
+int YAAACD::helpers::orientation(
+    const Vertex& a,
+    const Vertex& b,
+    const Vertex& c,
+    const Vertex& d
+) {
+    const double bax = b.x - a.x, bay = b.y - a.y, baz = b.z - a.z;
+    const double cax = c.x - a.x, cay = c.y - a.y, caz = c.z - a.z;
+    const double dax = d.x - a.x, day = d.y - a.y, daz = d.z - a.z;
+
+    const double bc_yz = bay * caz, cb_yz = baz * cay;
+    const double bc_zx = baz * cax, cb_zx = bax * caz;
+    const double bc_xy = bax * cay, cb_xy = bay * cax;
+
+    const double det = dax * (bc_yz - cb_yz) + day * (bc_zx - cb_zx) +
+                       daz * (bc_xy - cb_xy);
+    const double permanent =
+        std::fabs(dax) * (std::fabs(bc_yz) + std::fabs(cb_yz)) +
+        std::fabs(day) * (std::fabs(bc_zx) + std::fabs(cb_zx)) +
+        std::fabs(daz) * (std::fabs(bc_xy) + std::fabs(cb_xy));
+
+    if (det > O3D_ERRBOUND * permanent) return 1;
+    if (-det > O3D_ERRBOUND * permanent) return -1;
+
+    return CGAL::orientation(
+        converters::to_Point_3(a),
+        converters::to_Point_3(b),
+        converters::to_Point_3(c),
+        converters::to_Point_3(d)
+    );
+}
+
+struct Point2 {
+    double x;
+    double y;
+};
+
+static int orientation_2d(const Point2& a, const Point2& b, const Point2& c) {
+    const double left = (a.x - c.x) * (b.y - c.y);
+    const double right = (a.y - c.y) * (b.x - c.x);
+    const double det = left - right;
+    const double bound = O2D_ERRBOUND * (std::fabs(left) + std::fabs(right));
+
+    if (det > bound) return 1;
+    if (-det > bound) return -1;
+
+    return CGAL::orientation(
+        CGALKernel::Point_2(a.x, a.y),
+        CGALKernel::Point_2(b.x, b.y),
+        CGALKernel::Point_2(c.x, c.y)
+    );
+}
+
+/* COPLANAR CASE
+ * Guigue-Devillers 2D overlap test: both triangles are first brought to
+ * counterclockwise order, then the position of p1 relative to the edges of
+ * the second triangle selects one of two edge/vertex region tests.
+ */
+
+static bool intersection_test_vertex(
+    const Point2& p1,
+    const Point2& q1,
+    const Point2& r1,
+    const Point2& p2,
+    const Point2& q2,
+    const Point2& r2
+) {
+    if (orientation_2d(r2, p2, q1) >= 0) {
+        if (orientation_2d(r2, q2, q1) <= 0) {
+            if (orientation_2d(p1, p2, q1) > 0)
+                return orientation_2d(p1, q2, q1) <= 0;
+            return orientation_2d(p1, p2, r1) >= 0 &&
+                   orientation_2d(q1, r1, p2) >= 0;
+        }
+        return orientation_2d(p1, q2, q1) <= 0 &&
+               orientation_2d(r2, q2, r1) <= 0 &&
+               orientation_2d(q1, r1, q2) >= 0;
+    }
+
+    if (orientation_2d(r2, p2, r1) < 0) return false;
+    if (orientation_2d(q1, r1, r2) >= 0)
+        return orientation_2d(p1, p2, r1) >= 0;
+    return orientation_2d(q1, r1, q2) >= 0 && orientation_2d(r2, r1, q2) >= 0;
+}
+
+static bool intersection_test_edge(
+    const Point2& p1,
+    const Point2& q1,
+    const Point2& r1,
+    const Point2& p2,
+    const Point2& r2
+) {
+    if (orientation_2d(r2, p2, q1) >= 0) {
+        if (orientation_2d(p1, p2, q1) >= 0)
+            return orientation_2d(p1, q1, r2) >= 0;
+        return orientation_2d(q1, r1, p2) >= 0 &&
+               orientation_2d(r1, p1, p2) >= 0;
+    }
+
+    if (orientation_2d(r2, p2, r1) < 0) return false;
+    if (orientation_2d(p1, p2, r1) < 0) return false;
+    return orientation_2d(p1, r1, r2) >= 0 || orientation_2d(q1, r1, r2) >= 0;
+}
+
+static bool ccw_triangles_intersect_2d(
+    const Point2& p1,
+    const Point2& q1,
+    const Point2& r1,
+    const Point2& p2,
+    const Point2& q2,
+    const Point2& r2
+) {
+    if (orientation_2d(p2, q2, p1) >= 0) {
+        if (orientation_2d(q2, r2, p1) >= 0) {
+            if (orientation_2d(r2, p2, p1) >= 0) return true;
+            return intersection_test_edge(p1, q1, r1, p2, r2);
+        }
+        if (orientation_2d(r2, p2, p1) >= 0)
+            return intersection_test_edge(p1, q1, r1, r2, q2);
+        return intersection_test_vertex(p1, q1, r1, p2, q2, r2);
+    }
+
+    if (orientation_2d(q2, r2, p1) >= 0) {
+        if (orientation_2d(r2, p2, p1) >= 0)
+            return intersection_test_edge(p1, q1, r1, q2, p2);
+        return intersection_test_vertex(p1, q1, r1, q2, r2, p2);
+    }
+    return intersection_test_vertex(p1, q1, r1, r2, p2, q2);
+}
+
+static bool triangles_intersect_2d(
+    const Point2& p1,
+    const Point2& q1,
+    const Point2& r1,
+    const Point2& p2,
+    const Point2& q2,
+    const Point2& r2
+) {
+    if (orientation_2d(p1, q1, r1) < 0) {
+        if (orientation_2d(p2, q2, r2) < 0)
+            return ccw_triangles_intersect_2d(p1, r1, q1, p2, r2, q2);
+        return ccw_triangles_intersect_2d(p1, r1, q1, p2, q2, r2);
+    }
+
+    if (orientation_2d(p2, q2, r2) < 0)
+        return ccw_triangles_intersect_2d(p1, q1, r1, p2, r2, q2);
+    return ccw_triangles_intersect_2d(p1, q1, r1, p2, q2, r2);
+}
+
+static bool coplanar_triangles_intersect(
+    const Triangle& triangle1,
+    const Triangle& triangle2
+) {
+    const Vertex &p1 = triangle1[0], &q1 = triangle1[1], &r1 = triangle1[2];
+
+    // Drop the dominant axis of the (approximate) normal; the projection of a
+    // non-degenerate triangle onto the remaining plane is non-degenerate.
+    const double nx = std::fabs(
+        (q1.y - p1.y) * (r1.z - p1.z) - (q1.z - p1.z) * (r1.y - p1.y)
+    );
+    const double ny = std::fabs(
+        (q1.z - p1.z) * (r1.x - p1.x) - (q1.x - p1.x) * (r1.z - p1.z)
+    );
+    const double nz = std::fabs(
+        (q1.x - p1.x) * (r1.y - p1.y) - (q1.y - p1.y) * (r1.x - p1.x)
+    );
+
+    auto project = [&](const Vertex& vertex) {
+        if (nx > nz && nx >= ny) return Point2{vertex.y, vertex.z};
+        if (ny > nz && ny >= nx) return Point2{vertex.x, vertex.z};
+        return Point2{vertex.x, vertex.y};
+    };
+
+    return triangles_intersect_2d(
+        project(triangle1[0]),
+        project(triangle1[1]),
+        project(triangle1[2]),
+        project(triangle2[0]),
+        project(triangle2[1]),
+        project(triangle2[2])
+    );
+}
+
+/* GENERAL CASE
+ * Once p1 is the only vertex of the first triangle on its side of the second
+ * triangle's plane (and p2 likewise), both triangles cross the line where the
+ * planes meet and overlap iff their intervals on that line overlap. The two
+ * interval comparisons reduce to two more orientation predicates.
+ */
+
+static bool check_min_max(
+    const Vertex& p1,
+    const Vertex& q1,
+    const Vertex& r1,
+    const Vertex& p2,
+    const Vertex& q2,
+    const Vertex& r2
+) {
+    if (helpers::orientation(q1, p2, p1, q2) > 0) return false;
+    return helpers::orientation(p1, p2, r1, r2) <= 0;
+}
+
+static bool triangles_intersect_3d(
+    const Triangle& triangle1,
+    const Triangle& triangle2,
+    const Vertex& p1,
+    const Vertex& q1,
+    const Vertex& r1,
+    const Vertex& p2,
+    const Vertex& q2,
+    const Vertex& r2,
+    int dp2,
+    int dq2,
+    int dr2
+) {
+    if (dp2 > 0) {
+        if (dq2 > 0) return check_min_max(p1, r1, q1, r2, p2, q2);
+        if (dr2 > 0) return check_min_max(p1, r1, q1, q2, r2, p2);
+        return check_min_max(p1, q1, r1, p2, q2, r2);
+    }
+
+    if (dp2 < 0) {
+        if (dq2 < 0) return check_min_max(p1, q1, r1, r2, p2, q2);
+        if (dr2 < 0) return check_min_max(p1, q1, r1, q2, r2, p2);
+        return check_min_max(p1, r1, q1, p2, q2, r2);
+    }
+
+    if (dq2 < 0) {
+        if (dr2 >= 0) return check_min_max(p1, r1, q1, q2, r2, p2);
+        return check_min_max(p1, q1, r1, p2, q2, r2);
+    }
+
+    if (dq2 > 0) {
+        if (dr2 > 0) return check_min_max(p1, r1, q1, p2, q2, r2);
+        return check_min_max(p1, q1, r1, q2, r2, p2);
+    }
+
+    if (dr2 > 0) return check_min_max(p1, q1, r1, r2, p2, q2);
+    if (dr2 < 0) return check_min_max(p1, r1, q1, r2, p2, q2);
+    return coplanar_triangles_intersect(triangle1, triangle2);
+}
+
+/**
+ * @brief Check if two triangles intersect (share at least one point).
+ *
+ * Guigue-Devillers overlap test expressed purely through orientation
+ * predicates, so no intersection object is ever constructed.
+ *
+ * @param triangle1 first triangle
+ * @param triangle2 second triangle
+ * @return true if triangles intersect
+ * @return false if triangles are disjoint
+ */
+bool YAAACD::helpers::triangles_intersect(
+    const Triangle& triangle1,
+    const Triangle& triangle2
+) {
+    const Vertex &p1 = triangle1[0], &q1 = triangle1[1], &r1 = triangle1[2];
+    const Vertex &p2 = triangle2[0], &q2 = triangle2[1], &r2 = triangle2[2];
+
+    const int dp1 = orientation(p2, q2, r2, p1);
+    const int dq1 = orientation(p2, q2, r2, q1);
+    const int dr1 = orientation(p2, q2, r2, r1);
+
+    if (dp1 * dq1 > 0 && dp1 * dr1 > 0) return false;
+
+    const int dp2 = orientation(p1, q1, r1, p2);
+    const int dq2 = orientation(p1, q1, r1, q2);
+    const int dr2 = orientation(p1, q1, r1, r2);
+
+    if (dp2 * dq2 > 0 && dp2 * dr2 > 0) return false;
+
+    // `swap` exchanges q2 and r2 (and their signs) so that the permuted
+    // first triangle sees the second one with a consistent orientation.
+    auto test = [&](const Vertex& a,
+                    const Vertex& b,
+                    const Vertex& c,
+                    bool swap) {
+        if (swap)
+            return triangles_intersect_3d(
+                triangle1, triangle2, a, b, c, p2, r2, q2, dp2, dr2, dq2
+            );
+        return triangles_intersect_3d(
+            triangle1, triangle2, a, b, c, p2, q2, r2, dp2, dq2, dr2
+        );
+    };
+
+    if (dp1 > 0) {
+        if (dq1 > 0) return test(r1, p1, q1, true);
+        if (dr1 > 0) return test(q1, r1, p1, true);
+        return test(p1, q1, r1, false);
+    }
+
+    if (dp1 < 0) {
+        if (dq1 < 0) return test(r1, p1, q1, false);
+        if (dr1 < 0) return test(q1, r1, p1, false);
+        return test(p1, q1, r1, true);
+    }
+
+    if (dq1 < 0) {
+        if (dr1 >= 0) return test(q1, r1, p1, true);
+        return test(p1, q1, r1, false);
+    }
+
+    if (dq1 > 0) {
+        if (dr1 > 0) return test(p1, q1, r1, true);
+        return test(q1, r1, p1, false);
+    }
+
+    if (dr1 > 0) return test(r1, p1, q1, false);
+    if (dr1 < 0) return test(r1, p1, q1, true);
+    return coplanar_triangles_intersect(triangle1, triangle2);
+}
@@ -0,0 +1,196 @@
+#include "../include/linear_octree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/mesh.hpp"
+#include "../include/partition.hpp"
+
+using namespace YAAACD;
+
+/**
+ * @brief Check if two nodes' boxes overlap on every axis.
+ */
+static bool overlaps(const LinearOctree::Node& a, const LinearOctree::Node& b) {
+    return a.lower.x <= b.upper.x && b.lower.x <= a.upper.x &&
+           a.lower.y <= b.upper.y && b.lower.y <= a.upper.y &&
+           a.lower.z <= b.upper.z && b.lower.z <= a.upper.z;
+}
+
+/**
+ * @brief Construct a new LinearOctree object.
+ *
+ * The subdivision rules are the same as the ones used by Octree::build(),
+ * so both engines end up with the same leaves for the same input.
+ *
+ * @param mesh mesh to store in the tree, can be shared with other engines
+ */
+LinearOctree::LinearOctree(std::shared_ptr<const IndexedMesh> mesh) {
+    this->_mesh = std::move(mesh);
+
+    if (!this->_mesh->size()) return;
+
+    const std::vector<AABB> boxes = triangle_bounds(*this->_mesh);
+    this->_indices.resize(this->_mesh->size());
+    for (uint32_t i = 0; i < this->_indices.size(); i++) this->_indices[i] = i;
+
+    AABB bounds;
+    for (const AABB& box : boxes) bounds.extend(box);
+
+    this->_nodes.emplace_back();
+    this->_nodes[0].lower = bounds.lower;
+    this->_nodes[0].upper = bounds.upper;
+    this->_build(0, boxes, 0, this->_mesh->size(), 0);
+}
+
+/**
+ * @brief Construct a new LinearOctree object from a triangle soup.
+ *
+ * @param triangles triangles to store in the tree
+ */
+LinearOctree::LinearOctree(const std::vector<Triangle>& triangles)
+    : LinearOctree(std::make_shared<const IndexedMesh>(triangles)) {}
+
+/**
+ * @brief Subdivide a node whose bounds are already set.
+ *
+ * The node's members are the range [first, first + count) of the index
+ * buffer, which is partitioned in place into the ranges of its children.
+ *
+ * @param node index of the node
+ * @param boxes AABBs of all triangles
+ * @param first first member of the node
+ * @param count number of members of the node
+ * @param level depth of the node
+ */
+__attribute__((annotate("oclint:suppress[bitwise operator in conditional]")))
+void LinearOctree::_build(
+    uint32_t node,
+    const std::vector<AABB>& boxes,
+    uint32_t first,
+    uint32_t count,
+    int level
+) {
+    uint32_t* members = this->_indices.data() + first;
+
+    OctantSplit split;
+    bool divide = helpers::should_split(count, this->_mesh->size(), level);
+    if (divide) {
+        const Node& current = this->_nodes[node];
+        const Vertex center(
+            (current.lower.x + current.upper.x) / 2,
+            (current.lower.y + current.upper.y) / 2,
+            (current.lower.z + current.upper.z) / 2
+        );
+        split = helpers::partition_octants(members, count, boxes, center);
+        divide = helpers::split_effective(split, count);
+    }
+
+    if (!divide) {
+        this->_nodes[node].first = first;
+        this->_nodes[node].count = count;
+        this->_nodes[node].pack = this->_packs.size();
+        pack_triangles(this->_packs, *this->_mesh, members, count);
+        return;
+    }
+
+    uint8_t mask = 0;
+    for (int i = 0; i < 8; i++)
+        if (split.count(i)) mask |= 1 << i;
+
+    // Children are reserved as one contiguous block before descending, so
+    // siblings stay adjacent and in octant (Morton) order.
+    const uint32_t first_child = this->_nodes.size();
+    this->_nodes[node].first = first_child;
+    this->_nodes[node].children = mask;
+    this->_nodes.resize(first_child + std::popcount(mask));
+
+    uint32_t child = first_child;
+    for (int i = 0; i < 8; i++) {
+        if (!(mask & (1 << i))) continue;
+
+        this->_nodes[child].lower = split.bounds[i].lower;
+        this->_nodes[child].upper = split.bounds[i].upper;
+        this->_build(
+            child++,
+            boxes,
+            first + split.offsets[i],
+            split.count(i),
+            level + 1
+        );
+    }
+}
+
+bool LinearOctree::_leaves_intersect(
+    const Node& leaf1,
+    const LinearOctree& other,
+    const Node& leaf2
+) const {
+    // The larger leaf is tested in SIMD packs, the smaller one triangle by
+    // triangle.
+    if (leaf1.count > leaf2.count)
+        return other._leaves_intersect(leaf2, *this, leaf1);
+
+    const uint32_t packs = pack_count(leaf2.count);
+
+    for (uint32_t i = leaf1.first; i < leaf1.first + leaf1.count; i++)
+        for (uint32_t j = leaf2.pack; j < leaf2.pack + packs; j++)
+            if (helpers::pack_intersects(
+                    this->_mesh->triangle(this->_indices[i]),
+                    other._packs[j]
+                ))
+                return true;
+
+    return false;
+}
+
+/**
+ * @brief Check if two linear octrees collide.
+ *
+ * Mirrors Octree::collides: node pairs whose boxes overlap are refined by
+ * descending into the children of whichever nodes have any, and leaf pairs
+ * are resolved with triangle-triangle tests.
+ *
+ * @param other tree to check against
+ * @return true if any pair of triangles intersects
+ */
+bool LinearOctree::collides(const LinearOctree& other) const {
+    if (this->_nodes.empty() || other._nodes.empty()) return false;
+
+    std::vector<std::array<uint32_t, 2>> pairs = {{0, 0}};
+
+    while (!pairs.empty()) {
+        auto [index1, index2] = pairs.back();
+        pairs.pop_back();
+
+        const Node& node1 = this->_nodes[index1];
+        const Node& node2 = other._nodes[index2];
+
+        if (!overlaps(node1, node2)) continue;
+
+        const uint32_t count1 = std::popcount(node1.children);
+        const uint32_t count2 = std::popcount(node2.children);
+
+        if (node1.is_leaf() && node2.is_leaf()) {
+            if (this->_leaves_intersect(node1, other, node2)) return true;
+        } else if (node2.is_leaf()) {
+            for (uint32_t i = 0; i < count1; i++)
+                pairs.push_back({node1.first + i, index2});
+        } else if (node1.is_leaf()) {
+            for (uint32_t j = 0; j < count2; j++)
+                pairs.push_back({index1, node2.first + j});
+        } else {
+            for (uint32_t i = 0; i < count1; i++)
+                for (uint32_t j = 0; j < count2; j++)
+                    pairs.push_back({node1.first + i, node2.first + j});
+        }
+    }
+
+    return false;
+}
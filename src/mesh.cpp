@@ -0,0 +1,148 @@
+#include "../include/mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/contacts.hpp"
+#include "../include/partition.hpp"
+
+using namespace YAAACD;
+
+namespace {
+
+struct VertexHash {
+    size_t operator()(const Vertex& vertex) const {
+        // Adding 0.0 maps -0.0 to 0.0, which compares equal to it.
+        const std::hash<double> hash;
+        size_t seed = hash(vertex.x + 0.0);
+        seed ^= hash(vertex.y + 0.0) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= hash(vertex.z + 0.0) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+
+        return seed;
+    }
+};
+
+}  // namespace
+
+/**
+ * @brief Construct a new IndexedMesh object from its buffers.
+ *
+ * @param vertices vertex buffer
+ * @param faces vertex indices of every triangle
+ */
+IndexedMesh::IndexedMesh(std::vector<Vertex> vertices, std::vector<Face> faces)
+    : vertices(std::move(vertices)), faces(std::move(faces)) {}
+
+/**
+ * @brief Construct a new IndexedMesh object from a triangle soup.
+ *
+ * Vertices with identical coordinates are merged.
+ *
+ * @param triangles triangles of the mesh
+ */
+IndexedMesh::IndexedMesh(const std::vector<Triangle>& triangles) {
+    std::unordered_map<Vertex, uint32_t, VertexHash> indices;
+    indices.reserve(triangles.size());
+    this->faces.reserve(triangles.size());
+
+    for (const Triangle& triangle : triangles) {
+        Face& face = this->faces.emplace_back();
+
+        for (int k = 0; k < 3; k++) {
+            auto [entry, inserted] =
+                indices.try_emplace(triangle[k], this->vertices.size());
+            if (inserted) this->vertices.push_back(triangle[k]);
+
+            face[k] = entry->second;
+        }
+    }
+}
+
+std::vector<Triangle> IndexedMesh::triangles() const {
+    std::vector<Triangle> triangles;
+    triangles.reserve(this->faces.size());
+
+    for (uint32_t i = 0; i < this->faces.size(); i++)
+        triangles.push_back(this->triangle(i));
+
+    return triangles;
+}
+
+/**
+ * @brief Precompute the AABB of every triangle.
+ */
+void IndexedMesh::compute_bounds() {
+    this->bounds.clear();
+    this->bounds.reserve(this->faces.size());
+
+    for (uint32_t i = 0; i < this->faces.size(); i++)
+        this->bounds.emplace_back(this->triangle(i));
+}
+
+/**
+ * @brief Return the AABB of every triangle of a mesh, reusing the
+ * precomputed ones if there are any.
+ *
+ * @param mesh mesh to enclose
+ * @return std::vector<AABB> one box per triangle
+ */
+std::vector<AABB> YAAACD::triangle_bounds(const IndexedMesh& mesh) {
+    if (!mesh.bounds.empty()) return mesh.bounds;
+
+    std::vector<AABB> boxes;
+    boxes.reserve(mesh.size());
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        boxes.emplace_back(mesh.triangle(i));
+
+    return boxes;
+}
+
+bool YAAACD::bruteforce_collides(
+    const IndexedMesh& mesh1,
+    const IndexedMesh& mesh2
+) {
+    for (uint32_t i = 0; i < mesh1.size(); i++) {
+        const Triangle triangle1 = mesh1.triangle(i);
+
+        for (uint32_t j = 0; j < mesh2.size(); j++)
+            if (helpers::triangles_intersect(triangle1, mesh2.triangle(j)))
+                return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report every pair of intersecting triangles by testing all pairs.
+ *
+ * @param mesh1 first mesh
+ * @param mesh2 second mesh
+ * @param callback callback receiving the contacts, returning false to stop
+ * @param query maximum number of contacts and whether to compute segments
+ * @return size_t number of contacts reported
+ */
+size_t YAAACD::bruteforce_contacts(
+    const IndexedMesh& mesh1,
+    const IndexedMesh& mesh2,
+    const ContactCallback& callback,
+    const ContactQuery& query
+) {
+    ContactSink sink(callback, query);
+
+    for (uint32_t i = 0; i < mesh1.size() && !sink.stopped(); i++) {
+        const Triangle triangle1 = mesh1.triangle(i);
+
+        for (uint32_t j = 0; j < mesh2.size(); j++) {
+            const Triangle triangle2 = mesh2.triangle(j);
+            if (!helpers::triangles_intersect(triangle1, triangle2)) continue;
+            if (!sink.report(i, j, triangle1, triangle2)) break;
+        }
+    }
+
+    return sink.count();
+}
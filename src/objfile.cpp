@@ -0,0 +1,320 @@
+#include "../include/objfile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/mesh.hpp"
+#include "../include/scheduler.hpp"
+
+using namespace YAAACD;
+
+namespace {
+
+/**
+ * @brief Part of an OBJ file that ends on a line boundary, with everything
+ * parsed from it. Face indices are kept as written until all chunks are
+ * parsed, since relative indices depend on the vertices of earlier chunks.
+ */
+struct Chunk {
+    const char* begin;
+    const char* end;
+    std::vector<Vertex> vertices;
+    std::vector<std::array<int64_t, 3>> faces;
+    std::vector<uint32_t> preceding;  // chunk vertices before each face
+    bool valid = true;
+
+    Chunk(const char* begin, const char* end) : begin(begin), end(end) {}
+};
+
+/**
+ * @brief Owns a read-only memory mapping of a whole file.
+ */
+struct Mapping {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    explicit Mapping(const std::string& filename) {
+        const int descriptor = open(filename.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            throw std::system_error(errno, std::generic_category(), filename);
+
+        struct stat status;
+        if (fstat(descriptor, &status) < 0) {
+            const int error = errno;
+            close(descriptor);
+            throw std::system_error(error, std::generic_category(), filename);
+        }
+
+        this->size = status.st_size;
+        if (this->size) {
+            void* address = mmap(
+                nullptr,
+                this->size,
+                PROT_READ,
+                MAP_PRIVATE,
+                descriptor,
+                0
+            );
+            if (address == MAP_FAILED) {
+                const int error = errno;
+                close(descriptor);
+                throw std::system_error(
+                    error,
+                    std::generic_category(),
+                    filename
+                );
+            }
+            this->data = static_cast<const char*>(address);
+        }
+
+        close(descriptor);
+    }
+
+    ~Mapping() {
+        if (this->data) munmap(const_cast<char*>(this->data), this->size);
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+};
+
+}  // namespace
+
+static bool is_blank(char character) {
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+static const char* skip_blanks(const char* position, const char* end) {
+    while (position < end && is_blank(*position)) position++;
+
+    return position;
+}
+
+static const char* parse_vertex(
+    const char* position,
+    const char* end,
+    Chunk& chunk
+) {
+    double coordinates[3];
+
+    for (double& coordinate : coordinates) {
+        position = skip_blanks(position, end);
+        if (position < end && *position == '+') position++;
+
+        auto [next, error] = std::from_chars(position, end, coordinate);
+        if (error != std::errc()) {
+            chunk.valid = false;
+            return end;
+        }
+        position = next;
+    }
+
+    chunk.vertices.emplace_back(coordinates[0], coordinates[1], coordinates[2]);
+
+    return position;
+}
+
+/**
+ * @brief Parse a face line (after the `f`) and fan-triangulate it.
+ *
+ * Only the vertex index of each `v`, `v/t`, `v//n` or `v/t/n` token is used.
+ */
+static void parse_face(
+    const char* position,
+    const char* end,
+    Chunk& chunk,
+    std::vector<int64_t>& polygon
+) {
+    polygon.clear();
+
+    while ((position = skip_blanks(position, end)) < end) {
+        int64_t index;
+        auto [next, error] = std::from_chars(position, end, index);
+        if (error != std::errc()) {
+            chunk.valid = false;
+            return;
+        }
+        polygon.push_back(index);
+
+        position = next;
+        while (position < end && !is_blank(*position)) position++;
+    }
+
+    if (polygon.size() < 3) {
+        chunk.valid = false;
+        return;
+    }
+
+    for (size_t i = 1; i + 1 < polygon.size(); i++) {
+        chunk.faces.push_back({polygon[0], polygon[i], polygon[i + 1]});
+        chunk.preceding.push_back(chunk.vertices.size());
+    }
+}
+
+static void parse_chunk(Chunk& chunk) {
+    std::vector<int64_t> polygon;
+
+    for (const char* line = chunk.begin; line < chunk.end;) {
+        const char* newline = static_cast<const char*>(
+            std::memchr(line, '\n', chunk.end - line)
+        );
+        const char* line_end = newline ? newline : chunk.end;
+        const char* position = skip_blanks(line, line_end);
+
+        // Only `v` and `f` statements matter; `vn`, `vt`, comments, groups,
+        // materials and so on are skipped.
+        if (line_end - position >= 2 && is_blank(position[1])) {
+            if (position[0] == 'v')
+                parse_vertex(position + 1, line_end, chunk);
+            else if (position[0] == 'f')
+                parse_face(position + 1, line_end, chunk, polygon);
+        }
+
+        line = line_end + 1;
+    }
+}
+
+/**
+ * @brief Run task(i) for i in [0, count), on the pool if there is one.
+ */
+static void run_all(
+    TaskPool* pool,
+    size_t count,
+    const std::function<void(size_t)>& task
+) {
+    if (!pool) {
+        for (size_t i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    TaskGroup group;
+    for (size_t i = 0; i < count; i++)
+        pool->submit(group, [&task, i]() {
+            task(i);
+        });
+    pool->wait(group);
+}
+
+/**
+ * @brief Parse OBJ data held in memory.
+ *
+ * The data is split into chunks of roughly `chunk_size` bytes ending on line
+ * boundaries, which are parsed independently (in parallel when a pool is
+ * given) with std::from_chars. Face indices are then resolved in a second
+ * parallel pass: positive indices are 1-based, negative ones are relative to
+ * the vertices defined so far. Polygons are fan-triangulated.
+ *
+ * @param data OBJ text
+ * @param size length of the text in bytes
+ * @param pool pool to parse on, or nullptr to parse on the calling thread
+ * @param chunk_size approximate number of bytes per chunk
+ * @return IndexedMesh parsed mesh
+ * @throw std::runtime_error on malformed statements or invalid indices
+ */
+IndexedMesh YAAACD::parse_obj(
+    const char* data,
+    size_t size,
+    TaskPool* pool,
+    size_t chunk_size
+) {
+    const char* end = data + size;
+
+    std::vector<Chunk> chunks;
+    for (const char* begin = data; begin < end;) {
+        const char* split = begin + std::min(chunk_size, size_t(end - begin));
+        const char* newline =
+            static_cast<const char*>(std::memchr(split, '\n', end - split));
+        const char* chunk_end = newline ? newline + 1 : end;
+
+        chunks.emplace_back(begin, chunk_end);
+        begin = chunk_end;
+    }
+
+    run_all(pool, chunks.size(), [&chunks](size_t i) {
+        parse_chunk(chunks[i]);
+    });
+
+    std::vector<size_t> vertex_offsets(chunks.size() + 1, 0);
+    std::vector<size_t> face_offsets(chunks.size() + 1, 0);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        vertex_offsets[i + 1] = vertex_offsets[i] + chunks[i].vertices.size();
+        face_offsets[i + 1] = face_offsets[i] + chunks[i].faces.size();
+    }
+
+    IndexedMesh mesh;
+    mesh.vertices.resize(vertex_offsets.back());
+    mesh.faces.resize(face_offsets.back());
+
+    const int64_t vertex_count = mesh.vertices.size();
+    std::atomic<bool> valid = true;
+
+    run_all(pool, chunks.size(), [&](size_t i) {
+        const Chunk& chunk = chunks[i];
+        if (!chunk.valid) valid = false;
+
+        std::copy(
+            chunk.vertices.begin(),
+            chunk.vertices.end(),
+            mesh.vertices.begin() + vertex_offsets[i]
+        );
+
+        for (size_t j = 0; j < chunk.faces.size(); j++) {
+            const int64_t defined = vertex_offsets[i] + chunk.preceding[j];
+
+            for (int k = 0; k < 3; k++) {
+                const int64_t raw = chunk.faces[j][k];
+                const int64_t index = raw > 0 ? raw - 1 : defined + raw;
+
+                if (raw == 0 || index < 0 || index >= vertex_count) {
+                    valid = false;
+                    return;
+                }
+                mesh.faces[face_offsets[i] + j][k] = index;
+            }
+        }
+    });
+
+    if (!valid) throw std::runtime_error("malformed OBJ data");
+
+    return mesh;
+}
+
+/**
+ * @brief Load an OBJ file through a memory mapping.
+ *
+ * @param filename path of the file
+ * @param pool pool to parse on, or nullptr to parse on the calling thread
+ * @return IndexedMesh loaded mesh
+ * @throw std::system_error if the file cannot be opened or mapped
+ * @throw std::runtime_error if the file is malformed
+ */
+IndexedMesh YAAACD::load_obj(const std::string& filename, TaskPool* pool) {
+    const Mapping mapping(filename);
+
+    return parse_obj(mapping.data, mapping.size, pool);
+}
+
+/**
+ * @brief Load the triangles of an OBJ file.
+ *
+ * @param filename path of the file
+ * @return std::vector<YAAACD::Triangle> triangles of the file
+ */
+std::vector<YAAACD::Triangle> parse_obj_file(std::string filename) {
+    return YAAACD::load_obj(filename).triangles();
+}
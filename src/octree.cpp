@@ -1,13 +1,38 @@
 #include "../include/octree.hpp"
 
-#include <CGAL/intersections.h>
-
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <new>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "../include/arena.hpp"
+#include "../include/ccd.hpp"
 #include "../include/common.hpp"
+#include "../include/contacts.hpp"
+#include "../include/distance.hpp"
+#include "../include/mesh.hpp"
+#include "../include/packs.hpp"
+#include "../include/partition.hpp"
+#include "../include/policy.hpp"
+#include "../include/ray.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/stats.hpp"
+#include "../include/trace.hpp"
+#include "../include/transform.hpp"
 
 using namespace YAAACD;
 
@@ -26,137 +51,1974 @@ constexpr int CHILDREN_1 = 0b01;
 constexpr int CHILDREN_2 = 0b10;
 constexpr int CHILDREN_BOTH = 0b11;
 
-Octree::Octree(
-    const std::vector<Triangle>& triangles,
-    Octree* root,
-    int level
+// Node pairs whose levels add up to less than this are handed to the task
+// pool as separate tasks; deeper pairs stay with the task that found them.
+constexpr int PARALLEL_DEPTH = 4;
+
+// Parent of the root pair of a collision front.
+constexpr uint32_t NO_PAIR = std::numeric_limits<uint32_t>::max();
+// Marks splits merged back into a single pair.
+constexpr uint32_t COLLAPSED = std::numeric_limits<uint32_t>::max();
+
+// Source of tree generations, unique across all trees.
+static std::atomic<uint64_t> generations = 0;
+
+// Nodes pending on a ray traversal stack: every visited inner node replaces
+// itself with up to 8 children, at most MAX_DEPTH_LIMIT times.
+constexpr size_t RAY_STACK_SIZE = 7 * MAX_DEPTH_LIMIT + 1;
+
+// Rays traced by one task of a batched raycast.
+constexpr size_t RAY_BATCH_GRAIN = 32 * RAY_PACKET_WIDTH;
+
+struct OctreeNode::Context {
+    std::shared_ptr<const IndexedMesh> mesh;
+    std::shared_ptr<IndexedMesh> refitted;  // `mesh` if refit() made it
+    std::vector<uint32_t> indices;
+    std::vector<AABB> boxes;  // for meshes without precomputed bounds
+    BuildStats stats;
+    size_t rebuilt = 0;  // triangles rebuilt by refit() since the last build
+    uint64_t generation = 0;  // changes whenever the nodes are replaced
+    uint64_t version = 0;  // incremented by every refit
+    Arena arena;
+    Builder builder = &OctreeNode::_build<DefaultOctreePolicy>;
+};
+
+// Whatever lives in the arena is abandoned rather than destroyed when it is
+// reset, which is only sound while none of it has anything to destroy.
+static_assert(std::is_trivially_destructible_v<OctreeNode>);
+static_assert(std::is_trivially_destructible_v<TrianglePack>);
+
+/**
+ * @brief Construct a new Octree object.
+ *
+ * The tree is not subdivided until build() is called, either explicitly or by
+ * the first query. It is subdivided by DefaultOctreePolicy.
+ *
+ * @param mesh mesh to store in the tree, can be shared with other engines
+ */
+Octree::Octree(std::shared_ptr<const IndexedMesh> mesh) {
+    this->_owned = std::make_unique<Context>();
+    this->_context = this->_owned.get();
+    this->reset(std::move(mesh));
+}
+
+/**
+ * @brief Construct a new Octree object from a triangle soup.
+ *
+ * @param triangles triangles to store in the tree
+ */
+Octree::Octree(const std::vector<Triangle>& triangles)
+    : Octree(std::make_shared<const IndexedMesh>(triangles)) {}
+
+/**
+ * @brief Destroy the tree. Its nodes are trivially destructible, so this
+ * only frees the blocks of the arena and the root's buffers.
+ */
+Octree::~Octree() = default;
+
+/**
+ * @brief Move a tree. `other` is left empty and may only be destroyed or
+ * assigned to. Assigning to a tree frees its own arena once the nodes of
+ * `other` have been taken over.
+ *
+ * @param other tree to move from
+ */
+Octree::Octree(Octree&& other) noexcept = default;
+Octree& Octree::operator=(Octree&& other) noexcept = default;
+
+/**
+ * @brief Construct a child node from one octant of its parent's partition.
+ *
+ * @param parent node being split
+ * @param split partition of the parent's members
+ * @param octant octant of the child
+ */
+OctreeNode::OctreeNode(
+    OctreeNode* parent,
+    const OctantSplit& split,
+    int octant
 ) {
-    std::vector<Vertex> vertices;
-    for (const Triangle& triangle : triangles)
-        std::for_each(
-            triangle.begin(),
-            triangle.end(),
-            [&vertices](const Vertex& vertex) {
-                vertices.push_back(vertex);
-            }
-        );
+    this->_bounds = BoundingBox(
+        split.bounds[octant].lower,
+        split.bounds[octant].upper,
+        parent->_level + 1
+    );
+    this->_context = parent->_context;
+    this->_level = parent->_level + 1;
+    this->_first = parent->_first + split.offsets[octant];
+    this->_count = split.count(octant);
+    this->_built = true;
+}
 
-    this->_bounds = BoundingBox(vertices);
-    this->_members = triangles;
-    this->_root = root ? root : this;
-    this->_level = level;
+/**
+ * @brief Construct the leaf over the straddlers of a loose split, the front
+ * of its parent's range. It is one level below its parent, like the octant
+ * children, but is no child of it.
+ *
+ * @param parent node being split
+ * @param split partition of the parent's members, with straddlers
+ */
+OctreeNode::OctreeNode(OctreeNode* parent, const OctantSplit& split) {
+    this->_bounds = BoundingBox(
+        split.straddler_bounds.lower,
+        split.straddler_bounds.upper,
+        parent->_level + 1
+    );
+    this->_context = parent->_context;
+    this->_level = parent->_level + 1;
+    this->_first = parent->_first;
+    this->_count = split.straddlers;
+    this->_built = true;
 }
 
-std::array<Octree*, 8> Octree::children() {
-    if (this->_level >= DEPTH_LIMIT ||
-        std::any_of(
-            this->_children.begin(),
-            this->_children.end(),
-            [](Octree* child) {
-                return child != nullptr;
-            }
-        ) ||
-        this->_members.size() < MIN_MEMBERS) {
-        return this->_children;
-    }
+/**
+ * @brief Move a node, leaving `other` empty. Only used to move roots.
+ *
+ * @param other node to move from
+ */
+OctreeNode::OctreeNode(OctreeNode&& other) noexcept
+    : _bounds(other._bounds),
+      _children(std::exchange(other._children, {})),
+      _child_bounds(other._child_bounds),
+      _packs(std::exchange(other._packs, nullptr)),
+      _pack_count(std::exchange(other._pack_count, 0)),
+      _straddlers(std::exchange(other._straddlers, nullptr)),
+      _context(std::exchange(other._context, nullptr)),
+      _level(other._level),
+      _first(other._first),
+      _count(std::exchange(other._count, 0)),
+      _built(std::exchange(other._built, false)),
+      _build_extent(other._build_extent),
+      _changed(other._changed) {}
+
+OctreeNode& OctreeNode::operator=(OctreeNode&& other) noexcept {
+    if (this == &other) return *this;
+
+    this->_bounds = other._bounds;
+    this->_children = std::exchange(other._children, {});
+    this->_child_bounds = other._child_bounds;
+    this->_packs = std::exchange(other._packs, nullptr);
+    this->_pack_count = std::exchange(other._pack_count, 0);
+    this->_straddlers = std::exchange(other._straddlers, nullptr);
+    this->_context = std::exchange(other._context, nullptr);
+    this->_level = other._level;
+    this->_first = other._first;
+    this->_count = std::exchange(other._count, 0);
+    this->_built = std::exchange(other._built, false);
+    this->_build_extent = other._build_extent;
+    this->_changed = other._changed;
+
+    return *this;
+}
+
+/**
+ * @brief Drop the current tree and start over with another mesh.
+ *
+ * The nodes are abandoned in the arena, which is rewound rather than freed,
+ * and the root's buffers keep their capacity, so rebuilding trees of similar
+ * size allocates nothing once the first one has been built. Like
+ * construction, the new tree is built lazily.
+ *
+ * @param mesh mesh to store in the tree
+ */
+void Octree::reset(std::shared_ptr<const IndexedMesh> mesh) {
+    Context& context = *this->_context;
+    context.arena.reset();
+    context.mesh = std::move(mesh);
+    if (context.refitted != context.mesh) context.refitted = nullptr;
+    context.stats = BuildStats();
+    context.rebuilt = 0;
+    context.generation = ++generations;
+
+    this->_bounds = BoundingBox(context.mesh->vertices);
+    this->_children = {nullptr};
+    this->_child_bounds = BoxPack();
+    this->_packs = nullptr;
+    this->_pack_count = 0;
+    this->_straddlers = nullptr;
+    this->_first = 0;
+    this->_count = context.mesh->size();
+    this->_built = false;
+}
+
+/**
+ * @brief Return the per-triangle boxes of a mesh: its precomputed bounds if
+ * it has any, otherwise `boxes` filled in place.
+ */
+static const std::vector<AABB>& mesh_bounds(
+    const IndexedMesh& mesh,
+    std::vector<AABB>& boxes
+) {
+    if (!mesh.bounds.empty()) return mesh.bounds;
+
+    boxes.resize(mesh.size());
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        boxes[i] = AABB(mesh.triangle(i));
+
+    return boxes;
+}
+
+/**
+ * @brief Sum of the edge lengths of a box along the three axes. Unlike the
+ * surface area, it does not vanish for flat boxes.
+ */
+static double box_extent(const BoundingBox& box) {
+    return (box.upper().x - box.lower().x) + (box.upper().y - box.lower().y) +
+           (box.upper().z - box.lower().z);
+}
+
+/**
+ * @brief Box of a node's bounds.
+ */
+static AABB node_box(const BoundingBox& bounds) {
+    AABB box;
+    box.lower = bounds.lower();
+    box.upper = bounds.upper();
+
+    return box;
+}
+
+/**
+ * @brief Subdivide the whole tree.
+ *
+ * Members are kept as one index buffer owned by the root; each node owns a
+ * contiguous range of it, which is partitioned in place into the ranges of
+ * its children with a single classification pass. Subtrees are independent
+ * once their range is known, so large ones are built in parallel on the
+ * pool. Leaves get their SIMD packs here as well, which makes every later
+ * query read-only. Nodes are split as the tree's policy decides, see
+ * OctreePolicy. Calling build() again on a built tree does nothing.
+ *
+ * @param pool pool to build on, or nullptr to build on the calling thread
+ * @return const BuildStats& size of the tree and build throughput
+ */
+const BuildStats& OctreeNode::build(TaskPool* pool) {
+    if (this->_built) return this->_context->stats;
+
+    YAAACD_TRACE_SPAN("Octree::build");
+    const auto start = std::chrono::steady_clock::now();
+
+    Context& context = *this->_context;
+    const IndexedMesh& mesh = *context.mesh;
+    const std::vector<AABB>& boxes = mesh_bounds(mesh, context.boxes);
+
+    context.indices.resize(mesh.size());
+    std::iota(context.indices.begin(), context.indices.end(), 0);
+
+    TaskGroup group;
+    BuildState state{boxes, context.indices.data(), pool, group};
+    (this->*context.builder)(state, node_box(this->_bounds));
+    if (pool) pool->wait(group);
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    context.stats.triangles = mesh.size();
+    context.stats.nodes = state.nodes;
+    context.stats.leaves = state.leaves;
+    context.stats.seconds = elapsed.count();
+    this->_built = true;
+
+    return context.stats;
+}
+
+/**
+ * @brief Count a node entering the build and record its extent.
+ *
+ * @param state build state
+ * @return size_t number of triangles in the whole tree
+ */
+size_t OctreeNode::_enter(BuildState& state) {
+    state.nodes++;
+    this->_build_extent = box_extent(this->_bounds);
 
-    std::array<BoundingBox*, 8> child_bounds = this->_bounds.children();
+    return this->_context->mesh->size();
+}
+
+/**
+ * @brief Turn a node into a leaf and pack its members.
+ *
+ * @param state build state
+ */
+void OctreeNode::_pack(BuildState& state) {
+    YAAACD_TRACE_SPAN("Octree::pack");
+    state.leaves++;
+    this->_pack_members();
+}
+
+/**
+ * @brief Pack the members of the node into the arena.
+ */
+void OctreeNode::_pack_members() {
+    Context& context = *this->_context;
+    const size_t count = pack_count(this->_count);
+    TrianglePack* packs = static_cast<TrianglePack*>(context.arena.allocate(
+        count * sizeof(TrianglePack),
+        alignof(TrianglePack)
+    ));
+    std::uninitialized_default_construct_n(packs, count);
+    pack_triangles(
+        packs,
+        *context.mesh,
+        context.indices.data() + this->_first,
+        this->_count
+    );
+
+    this->_packs = packs;
+    this->_pack_count = count;
+}
+
+/**
+ * @brief Keep the straddlers of a loose split with the node, as a packed
+ * leaf over the front of its range.
+ *
+ * @param split accepted partition of the node's members, with straddlers
+ */
+void OctreeNode::_add_straddlers(const OctantSplit& split) {
+    void* memory = this->_context->arena.allocate(
+        sizeof(OctreeNode),
+        alignof(OctreeNode)
+    );
+    this->_straddlers = new (memory) OctreeNode(this, split);
+    this->_straddlers->_pack_members();
+}
+
+/**
+ * @brief Create a child for every non-empty octant of a partition.
+ *
+ * @param split accepted partition of the node's members
+ */
+void OctreeNode::_add_octant_children(const OctantSplit& split) {
+    std::array<const BoundingBox*, 8> bounds = {nullptr};
     for (int i = 0; i < 8; i++) {
-        std::vector<Triangle> contained_objects;
-        std::copy_if(
-            this->_members.begin(),
-            this->_members.end(),
-            std::back_inserter(contained_objects),
-            [&child_bounds, i](const Triangle& triangle) {
-                for (const Vertex& vertex : triangle) {
-                    if (child_bounds[i]->contains(vertex)) return true;
-                }
-                return false;
-            }
+        if (!split.count(i)) continue;
+
+        void* memory = this->_context->arena.allocate(
+            sizeof(OctreeNode),
+            alignof(OctreeNode)
+        );
+        this->_children[i] = new (memory) OctreeNode(this, split, i);
+        bounds[i] = &this->_children[i]->bounds();
+    }
+    this->_child_bounds = BoxPack(bounds);
+}
+
+/**
+ * @brief Make the tree build with another policy.
+ *
+ * @param builder build instantiated for the policy
+ */
+void OctreeNode::_set_builder(Builder builder) {
+    this->_context->builder = builder;
+}
+
+/**
+ * @brief Return what a traversal splits an inner node into: its children
+ * and the leaf over its straddlers, if any.
+ */
+std::array<OctreeNode*, 9> OctreeNode::_parts() const {
+    std::array<OctreeNode*, 9> parts;
+    std::copy(this->_children.begin(), this->_children.end(), parts.begin());
+    parts[8] = this->_straddlers;
+
+    return parts;
+}
+
+/**
+ * @brief Box of the node's bounds.
+ */
+AABB OctreeNode::_box() const {
+    return node_box(this->_bounds);
+}
+
+/**
+ * @brief Update the tree for new positions of the mesh vertices.
+ *
+ * The faces stay the same, so every node keeps its members. One bottom-up
+ * pass recomputes the bounds of all nodes from the moved triangles and
+ * repacks the leaves in place; a top-down pass then rebuilds the topmost
+ * subtrees that grew past `threshold` times their extent when they were
+ * built. Rebuilt subtrees leave their old nodes in the arena, so once
+ * refits have rebuilt as many triangles as the mesh holds, the next refit
+ * rebuilds the whole tree into a rewound arena instead. A tree that was
+ * never built just switches to the new mesh.
+ *
+ * @param positions new vertex positions, one per vertex of the mesh
+ * @param threshold growth factor that triggers a subtree rebuild
+ * @return RefitStats size of the updated tree and amount of rebuilding
+ * @throw std::invalid_argument if the number of positions does not match
+ */
+RefitStats Octree::refit(std::vector<Vertex> positions, double threshold) {
+    Context& context = *this->_context;
+    if (positions.size() != context.mesh->vertices.size())
+        throw std::invalid_argument("refit needs one position per vertex");
+
+    YAAACD_TRACE_SPAN("Octree::refit");
+    const auto start = std::chrono::steady_clock::now();
+
+    // A mesh shared with other engines is replaced rather than modified,
+    // which copies its faces once. The copy belongs to the tree, so later
+    // refits only swap its positions, as long as nothing else holds it.
+    std::shared_ptr<IndexedMesh> mesh;
+    if (context.refitted && context.refitted.use_count() == 2) {
+        mesh = context.refitted;
+        mesh->vertices = std::move(positions);
+    } else {
+        mesh = std::make_shared<IndexedMesh>(
+            std::move(positions),
+            context.mesh->faces
         );
-        if (contained_objects.size() < 0.9 * this->_members.size() &&
-            contained_objects.size() >
-                (0.025 / 100) * this->_root->_members.size())
-            this->_children[i] = new Octree(
-                contained_objects,
-                this->_root ? this->_root : this,
-                this->_level + 1
+        context.refitted = mesh;
+    }
+
+    RefitStats stats;
+    if (!this->_built || context.rebuilt >= mesh->size()) {
+        const bool built = this->_built;
+        this->reset(std::move(mesh));
+        if (built) {
+            stats.nodes = this->build().nodes;
+            stats.rebuilt_triangles = this->_count;
+            stats.full_rebuild = true;
+        }
+    } else {
+        context.mesh = std::move(mesh);
+        const std::vector<AABB>& boxes =
+            mesh_bounds(*context.mesh, context.boxes);
+
+        this->_refit(boxes, ++context.version);
+
+        TaskGroup group;
+        BuildState state{boxes, context.indices.data(), nullptr, group};
+        this->_rebuild_degraded(state, threshold, stats.rebuilt_triangles);
+        if (stats.rebuilt_triangles) context.generation = ++generations;
+
+        context.rebuilt += stats.rebuilt_triangles;
+        context.stats.nodes = state.nodes;
+        context.stats.leaves = state.leaves;
+        stats.nodes = state.nodes;
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    stats.seconds = elapsed.count();
+
+    return stats;
+}
+
+/**
+ * @brief Recompute the bounds of the subtree and repack its leaves.
+ *
+ * Nodes whose bounds (or, for leaves, whose triangles) change are stamped
+ * with `version`, which lets collision fronts skip the others.
+ *
+ * @param boxes box of every triangle of the mesh
+ * @param version version of the tree after this refit
+ * @return AABB new bounds of the node
+ */
+AABB OctreeNode::_refit(const std::vector<AABB>& boxes, uint64_t version) {
+    Context& context = *this->_context;
+    AABB box;
+
+    if (this->_packs) {
+        const uint32_t* members = context.indices.data() + this->_first;
+        for (uint32_t i = 0; i < this->_count; i++)
+            box.extend(boxes[members[i]]);
+
+        for (uint32_t i = 0; i < this->_pack_count; i++) {
+            const uint32_t first = i * PACK_WIDTH;
+            TrianglePack pack;
+            pack_triangles(
+                &pack,
+                *context.mesh,
+                members + first,
+                std::min<uint32_t>(PACK_WIDTH, this->_count - first)
             );
-        else
-            this->_children[i] = nullptr;
+
+            TrianglePack& current = this->_packs[i];
+            if (std::memcmp(
+                    pack.coordinates,
+                    current.coordinates,
+                    sizeof(pack.coordinates)
+                )) {
+                this->_changed = version;
+                current = pack;
+            }
+        }
+    } else {
+        std::array<const BoundingBox*, 8> bounds = {nullptr};
+        for (int i = 0; i < 8; i++) {
+            if (!this->_children[i]) continue;
+
+            box.extend(this->_children[i]->_refit(boxes, version));
+            bounds[i] = &this->_children[i]->_bounds;
+        }
+        this->_child_bounds = BoxPack(bounds);
+        if (this->_straddlers)
+            box.extend(this->_straddlers->_refit(boxes, version));
+    }
+
+    if (this->_count &&
+        !(box.lower == this->_bounds.lower() &&
+          box.upper == this->_bounds.upper())) {
+        this->_bounds = BoundingBox(box.lower, box.upper, this->_level);
+        this->_changed = version;
     }
 
+    return box;
+}
+
+/**
+ * @brief Rebuild the topmost degraded subtrees and count the nodes of the
+ * updated tree.
+ *
+ * @param state build state collecting the node and leaf counts
+ * @param threshold growth factor that triggers a rebuild
+ * @param rebuilt incremented by the members of every rebuilt subtree
+ */
+void OctreeNode::_rebuild_degraded(
+    BuildState& state,
+    double threshold,
+    size_t& rebuilt
+) {
+    if (box_extent(this->_bounds) > threshold * this->_build_extent) {
+        rebuilt += this->_count;
+        // The old subtree is abandoned in the arena.
+        this->_children = {nullptr};
+        this->_packs = nullptr;
+        this->_pack_count = 0;
+        this->_straddlers = nullptr;
+        (this->*this->_context->builder)(state, node_box(this->_bounds));
+        return;
+    }
+
+    state.nodes++;
+    if (this->_packs) state.leaves++;
+
+    for (OctreeNode* child : this->_children)
+        if (child) child->_rebuild_degraded(state, threshold, rebuilt);
+}
+
+std::array<OctreeNode*, 8> OctreeNode::children() {
+    if (!this->_built) this->build();
+
     return this->_children;
 }
 
-const BoundingBox& Octree::bounds() const {
+const BoundingBox& OctreeNode::bounds() const {
     return this->_bounds;
 }
 
-bool Octree::has_children() {
-    std::array<Octree*, 8> child_nodes = this->children();
+int OctreeNode::level() const {
+    return this->_level;
+}
+
+bool OctreeNode::has_children() {
+    std::array<OctreeNode*, 8> child_nodes = this->children();
 
     return std::any_of(
         child_nodes.begin(),
         child_nodes.end(),
-        [](const Octree* child) {
+        [](const OctreeNode* child) {
             return child != nullptr;
         }
     );
 }
 
-int Octree::children_position(Octree* child1, Octree* child2) {
+/**
+ * @brief Return the leaf over the straddlers of a node of a loose tree,
+ * the members fitting in no loose octant. Queries test it along with the
+ * children of the node.
+ *
+ * @return OctreeNode* leaf over the straddlers, nullptr if there are none
+ */
+OctreeNode* OctreeNode::straddlers() {
+    if (!this->_built) this->build();
+
+    return this->_straddlers;
+}
+
+/**
+ * @brief Return the members stored in the node itself as SIMD packs: all
+ * members of a leaf, the straddlers of an inner node of a loose tree.
+ *
+ * @return std::span<const TrianglePack> packed members (empty for other
+ * inner nodes)
+ */
+std::span<const TrianglePack> OctreeNode::packs() {
+    if (!this->_built) this->build();
+
+    const OctreeNode* leaf = this->_straddlers ? this->_straddlers : this;
+    return {leaf->_packs, leaf->_pack_count};
+}
+
+/**
+ * @brief Return the ids of the triangles below the node.
+ *
+ * @return std::span<const uint32_t> range of the root's index buffer
+ */
+std::span<const uint32_t> OctreeNode::members() {
+    if (!this->_built) this->build();
+
+    return {this->_context->indices.data() + this->_first, this->_count};
+}
+
+/**
+ * @brief Return the memory reserved by the arena of the tree.
+ *
+ * @return size_t arena capacity in bytes
+ */
+size_t OctreeNode::arena_capacity() const {
+    return this->_context->arena.capacity();
+}
+
+int OctreeNode::children_position(OctreeNode* child1, OctreeNode* child2) {
     int first = child1->has_children() ? CHILDREN_1 : 0;
     int second = child2->has_children() ? CHILDREN_2 : 0;
 
     return first | second;
 }
 
-bool Octree::collides(Octree* octree) {
-    std::vector<Octree*> pairs = {this, octree};
+/**
+ * @brief Test two leaves against each other. The larger leaf is tested in
+ * SIMD packs, the smaller one triangle by triangle.
+ *
+ * @param leaf1 first leaf
+ * @param leaf2 second leaf
+ * @param stats stats policy
+ * @return true if any pair of members intersects
+ */
+template <typename Stats>
+bool OctreeNode::_leaves_intersect(
+    const OctreeNode* leaf1,
+    const OctreeNode* leaf2,
+    Stats stats
+) {
+    if (leaf1->_count > leaf2->_count) std::swap(leaf1, leaf2);
+
+    return leaf1->_leaf_intersects(*leaf2, stats);
+}
+
+/**
+ * @brief Return whether a node pair is refined by splitting the first node
+ * rather than the second. Children are one level deeper, so the node with
+ * the lower level is the larger one.
+ *
+ * @param position children position of the pair
+ * @param level1 level of the first node
+ * @param level2 level of the second node
+ */
+static bool split_first(int position, int level1, int level2) {
+    return position == CHILDREN_1 ||
+           (position == CHILDREN_BOTH && level1 <= level2);
+}
+
+/**
+ * @brief Test one node pair.
+ *
+ * Leaf pairs are resolved with triangle tests; otherwise the overlapping
+ * child pairs are pushed onto the pair stack.
+ *
+ * @param tree1 first node
+ * @param tree2 second node
+ * @param pairs pair stack (first node, second node, ...)
+ * @param stats stats policy
+ * @return true if the nodes are leaves with intersecting triangles
+ */
+template <typename Stats>
+bool OctreeNode::_visit(
+    OctreeNode* tree1,
+    OctreeNode* tree2,
+    std::vector<OctreeNode*>& pairs,
+    Stats stats
+) {
+    stats.visit();
+    stats.box_test();
+    if (!tree1->bounds().intersects(tree2->bounds())) {
+        stats.prune();
+        return false;
+    }
+
+    const int position = OctreeNode::children_position(tree1, tree2);
+    if (position == CHILDREN_NONE) {
+        YAAACD_TRACE_SPAN("Octree::leaf_test");
+        stats.leaf_test();
+        [[maybe_unused]] const auto timer = stats.time(&QueryStats::leaf_ns);
+
+        return OctreeNode::_leaves_intersect(tree1, tree2, stats);
+    }
+
+    OctreeNode::_push_children(tree1, tree2, position, pairs, stats);
+
+    return false;
+}
+
+/**
+ * @brief Push the child pairs of an overlapping node pair with at least one
+ * inner node.
+ *
+ * @param tree1 first node
+ * @param tree2 second node
+ * @param position children position of the pair
+ * @param pairs pair stack (first node, second node, ...)
+ * @param stats stats policy
+ */
+template <typename Stats>
+void OctreeNode::_push_children(
+    OctreeNode* tree1,
+    OctreeNode* tree2,
+    int position,
+    std::vector<OctreeNode*>& pairs,
+    Stats stats
+) {
+    switch (position) {
+        case CHILDREN_1:
+            for (auto child : tree1->_parts())
+                if (child) {
+                    pairs.push_back(child);
+                    pairs.push_back(tree2);
+                }
+            break;
+        case CHILDREN_2:
+            for (auto child : tree2->_parts())
+                if (child) {
+                    pairs.push_back(tree1);
+                    pairs.push_back(child);
+                }
+            break;
+        case CHILDREN_BOTH:
+            // One batched test per part of tree1 against all children of
+            // tree2; only overlapping pairs are pushed. Straddlers of tree2
+            // are tested on their own.
+            for (auto child1 : tree1->_parts()) {
+                if (!child1) continue;
+
+                const uint8_t overlapping =
+                    child1->bounds().intersects(tree2->_child_bounds);
+                for (int i = 0; i < 8; i++)
+                    if (overlapping & (1 << i)) {
+                        pairs.push_back(child1);
+                        pairs.push_back(tree2->_children[i]);
+                    }
+
+                OctreeNode* straddlers = tree2->_straddlers;
+                const bool straddling =
+                    straddlers &&
+                    child1->bounds().intersects(straddlers->bounds());
+                if (straddling) {
+                    pairs.push_back(child1);
+                    pairs.push_back(straddlers);
+                }
+
+                if constexpr (Stats::enabled) {
+                    stats.box_test();
+                    for (int i = 0; i < 8; i++)
+                        if (tree2->_children[i] && !(overlapping & (1 << i)))
+                            stats.prune();
+                    if (straddlers) stats.box_test();
+                    if (straddlers && !straddling) stats.prune();
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Report every intersecting pair of members of two leaves.
+ *
+ * @param leaf1 leaf of the queried tree
+ * @param leaf2 leaf of the other tree
+ * @param sink sink receiving the contacts
+ */
+void OctreeNode::_leaf_contacts(
+    const OctreeNode* leaf1,
+    const OctreeNode* leaf2,
+    ContactSink& sink
+) {
+    const bool swapped = leaf1->_count > leaf2->_count;
+    const OctreeNode* scalar = swapped ? leaf2 : leaf1;
+    const OctreeNode* packed = swapped ? leaf1 : leaf2;
+
+    const IndexedMesh& mesh = *scalar->_context->mesh;
+    const std::vector<uint32_t>& indices = scalar->_context->indices;
+
+    for (uint32_t i = scalar->_first; i < scalar->_first + scalar->_count;
+         i++) {
+        const uint32_t id = indices[i];
+        const Triangle triangle = mesh.triangle(id);
+
+        for (uint32_t j = 0; j < packed->_pack_count; j++)
+            if (!helpers::pack_contacts(
+                    triangle,
+                    id,
+                    packed->_packs[j],
+                    sink,
+                    swapped
+                ))
+                return;
+    }
+}
+
+/**
+ * @brief Test the members of this leaf against the packs of another leaf.
+ *
+ * @param packed leaf to test against
+ * @param stats stats policy
+ * @return true if any pair of members intersects
+ */
+template <typename Stats>
+bool OctreeNode::_leaf_intersects(const OctreeNode& packed, Stats stats) const {
+    const IndexedMesh& mesh = *this->_context->mesh;
+    const std::vector<uint32_t>& indices = this->_context->indices;
+    const std::span<const TrianglePack> packs(
+        packed._packs,
+        packed._pack_count
+    );
+
+    for (uint32_t i = this->_first; i < this->_first + this->_count; i++) {
+        const Triangle triangle = mesh.triangle(indices[i]);
+
+        for (const TrianglePack& pack : packs) {
+            stats.triangle_tests(pack.size);
+            if (helpers::pack_intersects(triangle, pack)) return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Test the members of this leaf, moved by a transformation, against
+ * the packs of another leaf.
+ *
+ * @param packed leaf to test against
+ * @param transform transformation from this tree's frame to packed's frame
+ * @return true if any pair of members intersects
+ */
+bool OctreeNode::_leaf_intersects(
+    const OctreeNode& packed,
+    const Transform& transform
+) const {
+    const IndexedMesh& mesh = *this->_context->mesh;
+    const std::vector<uint32_t>& indices = this->_context->indices;
+    const std::span<const TrianglePack> packs(
+        packed._packs,
+        packed._pack_count
+    );
+
+    for (uint32_t i = this->_first; i < this->_first + this->_count; i++) {
+        const Triangle triangle = transform.apply(mesh.triangle(indices[i]));
+
+        for (const TrianglePack& pack : packs)
+            if (helpers::pack_intersects(triangle, pack)) return true;
+    }
+
+    return false;
+}
+
+bool OctreeNode::collides(OctreeNode* octree) {
+    return this->_collides(octree, NoStats());
+}
+
+/**
+ * @brief Check if two octrees collide, recording what the query did.
+ *
+ * @param octree tree to check against
+ * @param stats stats the counters and timings of the query are added to
+ * @return true if the trees collide
+ */
+bool OctreeNode::collides(OctreeNode* octree, QueryStats& stats) {
+    return this->_collides(octree, RecordStats(stats));
+}
+
+/**
+ * @brief Depth-first traversal of the node pairs of two octrees, building
+ * them first if needed.
+ *
+ * @param octree tree to check against
+ * @param stats stats policy
+ * @return true if the trees collide
+ */
+template <typename Stats>
+bool OctreeNode::_collides(OctreeNode* octree, Stats stats) {
+    {
+        [[maybe_unused]] const auto timer = stats.time(&QueryStats::build_ns);
+        this->build();
+        octree->build();
+    }
+
+    YAAACD_TRACE_SPAN("Octree::collides");
+    [[maybe_unused]] const auto timer =
+        stats.time(&QueryStats::traversal_ns, &QueryStats::leaf_ns);
+    std::vector<OctreeNode*> pairs = {this, octree};
 
     while (!pairs.empty()) {
-        Octree* tree1 = pairs.back();
+        OctreeNode* tree2 = pairs.back();
         pairs.pop_back();
 
-        Octree* tree2 = pairs.back();
+        OctreeNode* tree1 = pairs.back();
         pairs.pop_back();
 
-        if (!tree1->bounds().intersects(tree2->bounds())) continue;
+        if (OctreeNode::_visit(tree1, tree2, pairs, stats)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check if two octrees collide, splitting the traversal across a pool.
+ *
+ * Both trees are built first (on the same pool), so that the traversal
+ * itself only reads them. Node pairs close to the roots are submitted as
+ * separate tasks and stolen by idle workers; deeper pairs are processed
+ * depth-first by the task that found them. The first intersecting leaf pair
+ * cancels all outstanding work.
+ *
+ * @param octree tree to check against
+ * @param pool pool to run the traversal on
+ * @return true if the trees collide
+ */
+bool OctreeNode::collides(OctreeNode* octree, TaskPool& pool) {
+    this->build(&pool);
+    octree->build(&pool);
+
+    std::atomic<bool> found = false;
+    TaskGroup group;
+
+    std::function<void(OctreeNode*, OctreeNode*)> task =
+        [&](OctreeNode* root1, OctreeNode* root2) {
+        YAAACD_TRACE_SPAN("Octree::collides task");
+        std::vector<OctreeNode*> pairs = {root1, root2};
+
+        while (!pairs.empty() && !found.load(std::memory_order_relaxed)) {
+            OctreeNode* tree2 = pairs.back();
+            pairs.pop_back();
+
+            OctreeNode* tree1 = pairs.back();
+            pairs.pop_back();
+
+            const size_t mark = pairs.size();
+            if (OctreeNode::_visit(tree1, tree2, pairs)) {
+                found.store(true, std::memory_order_relaxed);
+                return;
+            }
 
-        switch (Octree::children_position(tree1, tree2)) {
-            case CHILDREN_NONE:
-                if (helpers::primes_intersect({tree1->_members, tree2->_members}
-                    )) {
-                    return true;
+            if (tree1->_level + tree2->_level >= PARALLEL_DEPTH) continue;
+
+            while (pairs.size() > mark) {
+                OctreeNode* child2 = pairs.back();
+                pairs.pop_back();
+
+                OctreeNode* child1 = pairs.back();
+                pairs.pop_back();
+
+                pool.submit(group, [&task, child1, child2]() {
+                    task(child1, child2);
+                });
+            }
+        }
+    };
+
+    pool.submit(group, [&task, this, octree]() {
+        task(this, octree);
+    });
+    pool.wait(group);
+
+    return found.load();
+}
+
+/**
+ * @brief Check if two octrees collide when the other tree is moved by a
+ * rigid transformation.
+ *
+ * Neither tree is rebuilt: node pairs are culled with an oriented box test,
+ * descending into the larger node of each overlapping pair, and only the
+ * triangles of the smaller leaf of a leaf pair are transformed, into the
+ * frame of the larger one whose packs are then used as they are.
+ *
+ * @param octree tree to check against, in its own frame
+ * @param transform transformation from the other tree's frame to this one's
+ * @return true if the trees collide
+ */
+bool OctreeNode::collides(OctreeNode* octree, const Transform& transform) {
+    this->build();
+    octree->build();
+
+    const Transform inverse = transform.inverse();
+    std::vector<OctreeNode*> pairs = {this, octree};
+
+    while (!pairs.empty()) {
+        OctreeNode* tree2 = pairs.back();
+        pairs.pop_back();
+
+        OctreeNode* tree1 = pairs.back();
+        pairs.pop_back();
+
+        if (!helpers::boxes_overlap(
+                tree1->bounds(),
+                tree2->bounds(),
+                transform
+            ))
+            continue;
+
+        const int position = OctreeNode::children_position(tree1, tree2);
+
+        if (position == CHILDREN_NONE) {
+            const bool intersect =
+                tree2->_count <= tree1->_count
+                    ? tree2->_leaf_intersects(*tree1, transform)
+                    : tree1->_leaf_intersects(*tree2, inverse);
+            if (intersect) return true;
+            continue;
+        }
+
+        if (split_first(position, tree1->_level, tree2->_level)) {
+            for (OctreeNode* child : tree1->_parts())
+                if (child) {
+                    pairs.push_back(child);
+                    pairs.push_back(tree2);
+                }
+        } else {
+            for (OctreeNode* child : tree2->_parts())
+                if (child) {
+                    pairs.push_back(tree1);
+                    pairs.push_back(child);
                 }
-                break;
-            case CHILDREN_1:
-                for (auto child : tree1->children())
-                    if (child) {
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check if two octrees collide, starting from the front left by the
+ * previous query between them.
+ *
+ * Front pairs whose nodes did not move since the previous query keep their
+ * outcome without being tested, so a query between trees that did not
+ * change visits no node pair at all. Other pairs are tested again: pairs
+ * that now overlap are refined like in a regular traversal, and splits
+ * whose pairs all separated are merged back into one pair. The front
+ * starts over from the roots when it was computed for other trees or when
+ * one of the trees was rebuilt since.
+ *
+ * @param octree tree to check against
+ * @param front front of the previous query between the two trees
+ * @return true if the trees collide
+ */
+bool OctreeNode::collides(OctreeNode* octree, CollisionFront& front) {
+    using Pair = CollisionFront::Pair;
+
+    this->build();
+    octree->build();
+
+    const Context& context1 = *this->_context;
+    const Context& context2 = *octree->_context;
+
+    if (front._tree1 != this || front._tree2 != octree ||
+        front._generation1 != context1.generation ||
+        front._generation2 != context2.generation) {
+        front.clear();
+        front._tree1 = this;
+        front._tree2 = octree;
+        front._generation1 = context1.generation;
+        front._generation2 = context2.generation;
+        front._pairs.push_back(
+            {this, octree, NO_PAIR, CollisionFront::UNTESTED, false}
+        );
+    }
+
+    std::vector<Pair>& next = front._next;
+    std::vector<Pair>& stack = front._stack;
+    next.clear();
+    front._visits = 0;
+    bool found = false;
+
+    for (Pair pair : front._pairs) {
+        pair.fresh = false;
+
+        const bool moved = pair.first->_changed > front._version1 ||
+                           pair.second->_changed > front._version2;
+
+        if (found) {
+            // Left for the next query, which has to test it again.
+            if (moved) pair.state = CollisionFront::UNTESTED;
+            next.push_back(pair);
+            continue;
+        }
+        if (!moved && pair.state != CollisionFront::UNTESTED) {
+            found = pair.state == CollisionFront::INTERSECTING;
+            next.push_back(pair);
+            continue;
+        }
+
+        stack.push_back(pair);
+        while (!stack.empty()) {
+            Pair current = stack.back();
+            stack.pop_back();
+
+            if (found) {
+                current.state = CollisionFront::UNTESTED;
+                next.push_back(current);
+                continue;
+            }
+
+            front._visits++;
+            current.fresh = true;
+
+            OctreeNode* tree1 = current.first;
+            OctreeNode* tree2 = current.second;
+            if (!tree1->_bounds.intersects(tree2->_bounds)) {
+                current.state = CollisionFront::SEPARATED;
+                next.push_back(current);
+                continue;
+            }
+
+            const int position = OctreeNode::children_position(tree1, tree2);
+            if (position == CHILDREN_NONE) {
+                found = OctreeNode::_leaves_intersect(tree1, tree2);
+                current.state = found ? CollisionFront::INTERSECTING
+                                      : CollisionFront::DISJOINT;
+                next.push_back(current);
+                continue;
+            }
+
+            const uint32_t split = front._splits.size();
+            front._splits.push_back({tree1, tree2, current.parent, 0});
+
+            const bool first = split_first(
+                position,
+                tree1->_level,
+                tree2->_level
+            );
+            for (OctreeNode* child : (first ? tree1 : tree2)->_parts()) {
+                if (!child) continue;
+
+                stack.push_back(
+                    {first ? child : tree1,
+                     first ? tree2 : child,
+                     split,
+                     CollisionFront::UNTESTED,
+                     false}
+                );
+                front._splits[split].children++;
+            }
+        }
+    }
+
+    front._version1 = context1.version;
+    front._version2 = context2.version;
+    std::swap(front._pairs, next);
+    front._coarsen();
+
+    return found;
+}
+
+/**
+ * @brief Forget the front, so that the next query starts from the roots.
+ */
+void CollisionFront::clear() {
+    this->_pairs.clear();
+    this->_splits.clear();
+    this->_tree1 = nullptr;
+    this->_tree2 = nullptr;
+    this->_generation1 = 0;
+    this->_generation2 = 0;
+    this->_version1 = 0;
+    this->_version2 = 0;
+    this->_visits = 0;
+}
+
+/**
+ * @brief Merge splits whose pairs are all separated back into one pair,
+ * if the split pair itself is separated.
+ *
+ * Splits are stored after the split they come from, so walking them
+ * backwards merges whole subtrees bottom-up. Only splits with a pair tested
+ * by the last query are considered, since the others were already
+ * considered when nothing had moved.
+ */
+void CollisionFront::_coarsen() {
+    for (Split& split : this->_splits) {
+        split.separated = 0;
+        split.touched = false;
+    }
+    for (const Pair& pair : this->_pairs) {
+        if (pair.parent == NO_PAIR) continue;
+
+        Split& parent = this->_splits[pair.parent];
+        if (pair.state == SEPARATED) parent.separated++;
+        if (pair.fresh) parent.touched = true;
+    }
+
+    bool merged = false;
+    for (size_t i = this->_splits.size(); i-- > 0;) {
+        Split& split = this->_splits[i];
+        if (!split.touched || split.separated != split.children) continue;
+
+        this->_visits++;
+        if (split.first->bounds().intersects(split.second->bounds()))
+            continue;
+
+        split.separated = COLLAPSED;
+        merged = true;
+        if (split.parent != NO_PAIR) {
+            this->_splits[split.parent].separated++;
+            this->_splits[split.parent].touched = true;
+        }
+    }
+    if (!merged) return;
+
+    auto collapsed = [this](uint32_t split) {
+        return split != NO_PAIR &&
+               this->_splits[split].separated == COLLAPSED;
+    };
+
+    // Pairs of merged splits are replaced by the topmost merged split.
+    this->_next.clear();
+    for (const Pair& pair : this->_pairs)
+        if (!collapsed(pair.parent)) this->_next.push_back(pair);
+    for (uint32_t i = 0; i < this->_splits.size(); i++) {
+        const Split& split = this->_splits[i];
+        if (collapsed(i) && !collapsed(split.parent))
+            this->_next.push_back(
+                {split.first, split.second, split.parent, SEPARATED, true}
+            );
+    }
+
+    // Drop the merged splits. Parents of the remaining splits and pairs are
+    // never merged, so their indices only shift down.
+    this->_remap.assign(this->_splits.size(), NO_PAIR);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < this->_splits.size(); i++) {
+        if (collapsed(i)) continue;
+
+        Split split = this->_splits[i];
+        if (split.parent != NO_PAIR) split.parent = this->_remap[split.parent];
+        this->_remap[i] = kept;
+        this->_splits[kept++] = split;
+    }
+    this->_splits.resize(kept);
+
+    for (Pair& pair : this->_next)
+        if (pair.parent != NO_PAIR) pair.parent = this->_remap[pair.parent];
+    std::swap(this->_pairs, this->_next);
+}
+
+/**
+ * @brief Report every pair of intersecting triangles of two octrees.
+ *
+ * Members are partitioned between the leaves and every leaf pair is reached
+ * through a single node pair, so each triangle pair is reported at most
+ * once without any deduplication. Contacts are handed to the callback as
+ * they are found; nothing is allocated per contact.
+ *
+ * @param octree tree to check against
+ * @param callback callback receiving the contacts, returning false to stop
+ * @param query maximum number of contacts and whether to compute segments
+ * @return size_t number of contacts reported
+ */
+size_t OctreeNode::contacts(
+    OctreeNode* octree,
+    const ContactCallback& callback,
+    const ContactQuery& query
+) {
+    this->build();
+    octree->build();
+
+    ContactSink sink(callback, query);
+    std::vector<OctreeNode*> pairs = {this, octree};
+
+    while (!pairs.empty() && !sink.stopped()) {
+        OctreeNode* tree2 = pairs.back();
+        pairs.pop_back();
+
+        OctreeNode* tree1 = pairs.back();
+        pairs.pop_back();
+
+        if (!tree1->bounds().intersects(tree2->bounds())) continue;
+
+        const int position = OctreeNode::children_position(tree1, tree2);
+        if (position == CHILDREN_NONE)
+            OctreeNode::_leaf_contacts(tree1, tree2, sink);
+        else
+            OctreeNode::_push_children(tree1, tree2, position, pairs);
+    }
+
+    return sink.count();
+}
+
+/**
+ * @brief Store pairs of intersecting triangles of two octrees in a buffer,
+ * stopping once it is full.
+ *
+ * @param octree tree to check against
+ * @param buffer buffer receiving the contacts
+ * @param segments whether to compute intersection segments
+ * @return size_t number of contacts stored
+ */
+size_t OctreeNode::contacts(
+    OctreeNode* octree,
+    std::span<Contact> buffer,
+    bool segments
+) {
+    size_t stored = 0;
+
+    return this->contacts(
+        octree,
+        [&buffer, &stored](const Contact& contact) {
+            buffer[stored++] = contact;
+            return true;
+        },
+        {buffer.size(), segments}
+    );
+}
+
+/**
+ * @brief Check if two faces share a vertex. Such triangles always touch,
+ * so self-collision queries do not report them.
+ */
+static bool faces_adjacent(const Face& face1, const Face& face2) {
+    for (uint32_t vertex : face1)
+        if (vertex == face2[0] || vertex == face2[1] || vertex == face2[2])
+            return true;
+
+    return false;
+}
+
+/**
+ * @brief Report the intersecting pairs of triangles of two leaves of the
+ * same tree, or of one leaf with itself, that do not share a vertex.
+ *
+ * @param leaf1 first leaf
+ * @param leaf2 second leaf, possibly `leaf1`
+ * @param mesh mesh of the tree
+ * @param sink sink receiving the contacts, with the lower id first
+ * @return false if the sink asked to stop
+ */
+static bool self_leaf_contacts(
+    OctreeNode* leaf1,
+    OctreeNode* leaf2,
+    const IndexedMesh& mesh,
+    ContactSink& sink
+) {
+    const std::span<const uint32_t> members = leaf1->members();
+    const std::span<const TrianglePack> packs = leaf2->packs();
+
+    for (uint32_t i = 0; i < members.size(); i++) {
+        const uint32_t id = members[i];
+        const Triangle triangle = mesh.triangle(id);
+
+        // Within one leaf, each pair is tested from its first member only.
+        const uint32_t first = leaf1 == leaf2 ? i + 1 : 0;
+        for (uint32_t j = first / PACK_WIDTH; j < packs.size(); j++) {
+            const TrianglePack& pack = packs[j];
+
+            uint32_t candidates = helpers::pack_candidates(triangle, pack);
+            if (j == first / PACK_WIDTH)
+                candidates &= ~0u << (first % PACK_WIDTH);
+
+            while (candidates) {
+                const int lane = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+
+                const uint32_t other = pack.ids[lane];
+                if (faces_adjacent(mesh.faces[id], mesh.faces[other]))
+                    continue;
+
+                const Triangle triangle2 = pack.triangle(lane);
+                if (!helpers::triangles_intersect(triangle, triangle2))
+                    continue;
+
+                const bool ordered = id < other;
+                if (!sink.report(
+                        ordered ? id : other,
+                        ordered ? other : id,
+                        ordered ? triangle : triangle2,
+                        ordered ? triangle2 : triangle
+                    ))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if the mesh of the tree intersects itself. Triangles sharing
+ * a vertex are never considered intersecting.
+ *
+ * @return true if two triangles without a common vertex intersect
+ */
+bool OctreeNode::self_collides() {
+    ContactQuery query;
+    query.max_contacts = 1;
+
+    return this->self_contacts(
+               [](const Contact&) {
+                   return true;
+               },
+               query
+           ) > 0;
+}
+
+/**
+ * @brief Report every pair of intersecting triangles of the tree's mesh that
+ * do not share a vertex, each pair once with the lower triangle id first.
+ *
+ * Node pairs are visited unordered: a node is paired with itself, which
+ * expands into each child (and its straddlers, in a loose tree) paired with
+ * itself and each overlapping pair of distinct ones, and distinct nodes are
+ * then traversed as in contacts().
+ *
+ * @param callback callback receiving the contacts, returning false to stop
+ * @param query maximum number of contacts and whether to compute segments
+ * @return size_t number of contacts reported
+ */
+size_t OctreeNode::self_contacts(
+    const ContactCallback& callback,
+    const ContactQuery& query
+) {
+    this->build();
+
+    const IndexedMesh& mesh = *this->_context->mesh;
+    ContactSink sink(callback, query);
+    std::vector<OctreeNode*> pairs = {this, this};
+
+    while (!pairs.empty() && !sink.stopped()) {
+        OctreeNode* tree2 = pairs.back();
+        pairs.pop_back();
+
+        OctreeNode* tree1 = pairs.back();
+        pairs.pop_back();
+
+        if (tree1 == tree2) {
+            if (!tree1->has_children()) {
+                self_leaf_contacts(tree1, tree1, mesh, sink);
+                continue;
+            }
+
+            for (int i = 0; i < 8; i++) {
+                OctreeNode* child = tree1->_children[i];
+                if (!child) continue;
+
+                pairs.push_back(child);
+                pairs.push_back(child);
+
+                const uint8_t overlapping =
+                    child->bounds().intersects(tree1->_child_bounds);
+                for (int j = i + 1; j < 8; j++)
+                    if (overlapping & (1 << j)) {
                         pairs.push_back(child);
-                        pairs.push_back(tree2);
+                        pairs.push_back(tree1->_children[j]);
                     }
-                break;
-            case CHILDREN_2:
-                for (auto child : tree2->children())
-                    if (child) {
-                        pairs.push_back(tree1);
-                        pairs.push_back(child);
+            }
+
+            if (OctreeNode* straddlers = tree1->_straddlers) {
+                pairs.push_back(straddlers);
+                pairs.push_back(straddlers);
+
+                const uint8_t overlapping =
+                    straddlers->bounds().intersects(tree1->_child_bounds);
+                for (int j = 0; j < 8; j++)
+                    if (overlapping & (1 << j)) {
+                        pairs.push_back(straddlers);
+                        pairs.push_back(tree1->_children[j]);
                     }
-                break;
-            case CHILDREN_BOTH:
-                for (auto child1 : tree1->children())
-                    for (auto child2 : tree2->children())
-                        if (child1 && child2) {
-                            pairs.push_back(child1);
-                            pairs.push_back(child2);
-                        }
-                break;
-            default:
-                break;
+            }
+            continue;
         }
+
+        if (!tree1->bounds().intersects(tree2->bounds())) continue;
+
+        const int position = OctreeNode::children_position(tree1, tree2);
+        if (position == CHILDREN_NONE)
+            self_leaf_contacts(tree1, tree2, mesh, sink);
+        else
+            OctreeNode::_push_children(tree1, tree2, position, pairs);
     }
 
-    return false;
+    return sink.count();
+}
+
+/**
+ * @brief Find the closest pair of triangles of two octrees.
+ *
+ * Branch and bound over node pairs: pairs are expanded in increasing order
+ * of the distance between their boxes, which bounds the distance of any
+ * triangle pair below them, and the search ends once the closest remaining
+ * pair is no closer than the best triangle pair found so far.
+ *
+ * @param octree tree to measure against
+ * @param upper_bound only pairs closer than this are looked for; a tight
+ * bound prunes most of the search, a negative one finds nothing
+ * @return DistanceResult closest pair and its distance, not found() if no
+ * pair is closer than `upper_bound`
+ */
+DistanceResult OctreeNode::distance(OctreeNode* octree, double upper_bound) {
+    return this->_nearest(octree, upper_bound, false);
+}
+
+/**
+ * @brief Check if two octrees come closer than a tolerance, stopping at the
+ * first pair of triangles that does.
+ *
+ * @param octree tree to measure against
+ * @param tolerance separation below which the trees are too close
+ * @return true if some pair of triangles is closer than `tolerance`, never
+ * for a negative one
+ */
+bool OctreeNode::closer_than(OctreeNode* octree, double tolerance) {
+    return this->_nearest(octree, tolerance, true).found();
+}
+
+/**
+ * @brief Branch and bound search for the closest triangle pair.
+ *
+ * @param octree tree to measure against
+ * @param upper_bound only pairs closer than this are looked for
+ * @param any stop at the first pair closer than `upper_bound`
+ * @return DistanceResult closest pair found
+ */
+DistanceResult OctreeNode::_nearest(
+    OctreeNode* octree,
+    double upper_bound,
+    bool any
+) {
+    struct Candidate {
+        double bound;  // squared distance between the boxes
+        OctreeNode* first;
+        OctreeNode* second;
+
+        bool operator>(const Candidate& other) const {
+            return this->bound > other.bound;
+        }
+    };
+
+    this->build();
+    octree->build();
+
+    // No pair is closer than a negative bound; squaring it would flip it.
+    DistanceResult result;
+    const double bound = upper_bound > 0 ? upper_bound : 0;
+    double best = bound * bound;
+
+    std::priority_queue<
+        Candidate,
+        std::vector<Candidate>,
+        std::greater<Candidate>>
+        queue;
+    auto push = [&](OctreeNode* tree1, OctreeNode* tree2) {
+        const double bound =
+            helpers::box_distance_squared(tree1->_bounds, tree2->_bounds);
+        if (bound < best) queue.push({bound, tree1, tree2});
+    };
+    push(this, octree);
+
+    while (!queue.empty() && queue.top().bound < best) {
+        const Candidate candidate = queue.top();
+        queue.pop();
+
+        OctreeNode* tree1 = candidate.first;
+        OctreeNode* tree2 = candidate.second;
+        const int position = OctreeNode::children_position(tree1, tree2);
+
+        if (position != CHILDREN_NONE) {
+            const bool first =
+                split_first(position, tree1->_level, tree2->_level);
+            for (OctreeNode* child : (first ? tree1 : tree2)->_parts())
+                if (child) push(first ? child : tree1, first ? tree2 : child);
+            continue;
+        }
+
+        const IndexedMesh& mesh1 = *tree1->_context->mesh;
+        const IndexedMesh& mesh2 = *tree2->_context->mesh;
+        const uint32_t* members1 =
+            tree1->_context->indices.data() + tree1->_first;
+        const uint32_t* members2 =
+            tree2->_context->indices.data() + tree2->_first;
+
+        for (uint32_t i = 0; i < tree1->_count; i++) {
+            const Triangle triangle1 = mesh1.triangle(members1[i]);
+
+            for (uint32_t j = 0; j < tree2->_count; j++) {
+                Vertex point1, point2;
+                const double distance = helpers::triangle_distance_squared(
+                    triangle1,
+                    mesh2.triangle(members2[j]),
+                    point1,
+                    point2
+                );
+                if (distance >= best) continue;
+
+                best = distance;
+                result.first = members1[i];
+                result.second = members2[j];
+                result.point1 = point1;
+                result.point2 = point2;
+                result.distance = std::sqrt(distance);
+                if (any || distance == 0) return result;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Find the earliest contact between two octrees moving rigidly over
+ * one time step.
+ *
+ * The query runs in this tree's frame, where the other tree's vertices move
+ * on straight lines between their relative start and end positions. Every
+ * node of the other tree thus sweeps a box whose corners move linearly, and
+ * the time it starts overlapping a node of this tree bounds every contact
+ * below the pair. Pairs are expanded in increasing order of that time, and
+ * the search ends once it is no earlier than the earliest contact found.
+ * Leaf pairs run vertex-face and edge-edge time of impact tests.
+ *
+ * @param octree tree to check against
+ * @param motion1 motion of this tree
+ * @param motion2 motion of the other tree
+ * @return ImpactResult earliest contact, not found() if the trees do not
+ * touch during the step
+ */
+ImpactResult OctreeNode::time_of_impact(
+    OctreeNode* octree,
+    const Motion& motion1,
+    const Motion& motion2
+) {
+    struct Candidate {
+        double enter;
+        OctreeNode* first;
+        OctreeNode* second;
+        AABB start;  // box of the second node at time 0
+        AABB end;  // box of the second node at time 1
+
+        bool operator>(const Candidate& other) const {
+            return this->enter > other.enter;
+        }
+    };
+
+    this->build();
+    octree->build();
+
+    const Transform start = motion1.start.inverse() * motion2.start;
+    const Transform end = motion1.end.inverse() * motion2.end;
+
+    ImpactResult result;
+    double best = std::numeric_limits<double>::infinity();
+
+    std::priority_queue<
+        Candidate,
+        std::vector<Candidate>,
+        std::greater<Candidate>>
+        queue;
+    auto push = [&](OctreeNode* tree1,
+                    OctreeNode* tree2,
+                    AABB box0,
+                    AABB box1) {
+        AABB fixed;
+        fixed.lower = tree1->_bounds.lower();
+        fixed.upper = tree1->_bounds.upper();
+
+        double enter;
+        if (helpers::sweep_overlap(fixed, box0, box1, best, enter))
+            queue.push({enter, tree1, tree2, box0, box1});
+    };
+    push(
+        this,
+        octree,
+        helpers::transformed_box(octree->_bounds, start),
+        helpers::transformed_box(octree->_bounds, end)
+    );
+
+    while (!queue.empty() && queue.top().enter < best) {
+        const Candidate candidate = queue.top();
+        queue.pop();
+
+        OctreeNode* tree1 = candidate.first;
+        OctreeNode* tree2 = candidate.second;
+        const int position = OctreeNode::children_position(tree1, tree2);
+
+        if (position != CHILDREN_NONE) {
+            if (split_first(position, tree1->_level, tree2->_level)) {
+                for (OctreeNode* child : tree1->_parts())
+                    if (child)
+                        push(child, tree2, candidate.start, candidate.end);
+            } else {
+                for (OctreeNode* child : tree2->_parts())
+                    if (child)
+                        push(
+                            tree1,
+                            child,
+                            helpers::transformed_box(child->_bounds, start),
+                            helpers::transformed_box(child->_bounds, end)
+                        );
+            }
+            continue;
+        }
+
+        const IndexedMesh& mesh1 = *tree1->_context->mesh;
+        const IndexedMesh& mesh2 = *tree2->_context->mesh;
+        const uint32_t* members1 =
+            tree1->_context->indices.data() + tree1->_first;
+        const uint32_t* members2 =
+            tree2->_context->indices.data() + tree2->_first;
+
+        for (uint32_t j = 0; j < tree2->_count; j++) {
+            const Triangle triangle = mesh2.triangle(members2[j]);
+            const Triangle start2 = start.apply(triangle);
+            const Triangle end2 = end.apply(triangle);
+            const AABB box0(start2);
+            const AABB box1(end2);
+
+            for (uint32_t i = 0; i < tree1->_count; i++) {
+                const Triangle triangle1 = mesh1.triangle(members1[i]);
+
+                double enter;
+                if (!helpers::sweep_overlap(
+                        AABB(triangle1),
+                        box0,
+                        box1,
+                        best,
+                        enter
+                    ))
+                    continue;
+
+                const double time = helpers::triangles_impact(
+                    triangle1,
+                    triangle1,
+                    start2,
+                    end2,
+                    best
+                );
+                if (time >= best) continue;
+
+                best = time;
+                result.time = time;
+                result.first = members1[i];
+                result.second = members2[j];
+                if (time == 0) return result;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Order in which the children of a node are visited by a ray so that
+ * nearer octants come first: octant `i ^ flip` is the i-th. The octant bits
+ * are those of partition_octants (x 0b100, y 0b010, z 0b001); along an axis
+ * the ray travels downwards, the upper octant is the near one.
+ *
+ * @param direction direction of the ray
+ */
+static int octant_flip(const Vertex& direction) {
+    return (direction.x < 0 ? 0b100 : 0) | (direction.y < 0 ? 0b010 : 0) |
+           (direction.z < 0 ? 0b001 : 0);
+}
+
+/**
+ * @brief Find the first triangle hit by a ray.
+ *
+ * @param ray ray to cast
+ * @param tmax distance up to which the ray is cast, in units of the length
+ * of its direction; 1 casts the segment from the origin to origin +
+ * direction
+ * @return RayHit closest hit, not found() if the ray hits nothing before
+ * `tmax`
+ */
+RayHit OctreeNode::raycast(const Ray& ray, double tmax) {
+    return this->_trace(ray, tmax, false);
+}
+
+/**
+ * @brief Check if a ray hits any triangle, stopping at the first hit found,
+ * which is not necessarily the closest.
+ *
+ * @param ray ray to cast
+ * @param tmax distance up to which the ray is cast
+ * @return true if some triangle is hit before `tmax`
+ */
+bool OctreeNode::occluded(const Ray& ray, double tmax) {
+    return this->_trace(ray, tmax, true).found();
+}
+
+/**
+ * @brief Find the first triangle hit by each ray of a batch.
+ *
+ * Rays are traced in packets of RAY_PACKET_WIDTH consecutive rays, which
+ * share the traversal: every node is tested against the whole packet with
+ * one SIMD slab test and entered if any ray of the packet reaches it. Rays
+ * with close origins and directions (camera rays, shadow rays towards a
+ * light) should be kept next to each other for packets to pay off.
+ *
+ * @param rays rays to cast
+ * @param hits receives the closest hit of each ray
+ * @param tmax distance up to which the rays are cast
+ * @param pool pool tracing the packets in parallel, or nullptr to trace
+ * them on the calling thread
+ * @throw std::invalid_argument if `hits` and `rays` differ in size
+ */
+void OctreeNode::raycast(
+    std::span<const Ray> rays,
+    std::span<RayHit> hits,
+    double tmax,
+    TaskPool* pool
+) {
+    if (hits.size() != rays.size())
+        throw std::invalid_argument("raycast needs one hit per ray");
+
+    this->build(pool);
+
+    auto trace = [this, rays, hits, tmax](size_t first, size_t last) {
+        for (size_t i = first; i < last; i += RAY_PACKET_WIDTH) {
+            const size_t count = std::min<size_t>(RAY_PACKET_WIDTH, last - i);
+            this->_trace_packet(
+                rays.subspan(i, count),
+                hits.subspan(i, count),
+                tmax
+            );
+        }
+    };
+
+    if (!pool) {
+        trace(0, rays.size());
+        return;
+    }
+
+    TaskGroup group;
+    for (size_t i = 0; i < rays.size(); i += RAY_BATCH_GRAIN)
+        pool->submit(group, [&trace, i, &rays]() {
+            trace(i, std::min(i + RAY_BATCH_GRAIN, rays.size()));
+        });
+    pool->wait(group);
+}
+
+/**
+ * @brief Trace one ray through the tree.
+ *
+ * Nodes are visited depth first, nearer children first. Child boxes are
+ * tested against the ray all at once, and a child is skipped when the ray
+ * enters it no closer than the best hit found by the time it is popped.
+ * The straddlers of a node of a loose tree are tested when it is popped.
+ *
+ * @param ray ray to cast
+ * @param tmax distance up to which the ray is cast
+ * @param any stop at the first hit
+ * @return RayHit closest hit found
+ */
+RayHit OctreeNode::_trace(const Ray& ray, double tmax, bool any) {
+    this->build();
+
+    struct Pending {
+        const OctreeNode* node;
+        double entry;
+    };
+
+    const Vertex inverse = helpers::ray_inverse(ray);
+    const int flip = octant_flip(ray.direction);
+
+    RayHit hit;
+    hit.distance = tmax;
+
+    std::array<Pending, RAY_STACK_SIZE> stack;
+    size_t size = 0;
+    double entry;
+    if (helpers::ray_box(ray, inverse, this->_bounds, tmax, entry))
+        stack[size++] = {this, entry};
+
+    while (size) {
+        const Pending pending = stack[--size];
+        if (pending.entry >= hit.distance) continue;
+
+        const OctreeNode* node = pending.node;
+        const OctreeNode* leaf = node->_packs ? node : node->_straddlers;
+        if (leaf) {
+            for (uint32_t i = 0; i < leaf->_pack_count; i++)
+                if (helpers::pack_raycast(ray, leaf->_packs[i], hit) && any)
+                    return hit;
+            if (leaf == node) continue;
+        }
+
+        double entries[8];
+        const uint32_t reached = helpers::ray_boxes(
+            ray,
+            inverse,
+            node->_child_bounds,
+            hit.distance,
+            entries
+        );
+        for (int i = 7; i >= 0; i--) {
+            const int octant = i ^ flip;
+            if (reached >> octant & 1)
+                stack[size++] = {node->_children[octant], entries[octant]};
+        }
+    }
+
+    return hit.found() ? hit : RayHit();
+}
+
+/**
+ * @brief Trace a packet of rays through the tree together.
+ *
+ * Children are ordered by the direction of the first ray. A ray stops
+ * taking part in the slab tests beyond its closest hit so far, and a node
+ * is skipped once no ray of the packet reaches it. The straddlers of a node
+ * of a loose tree are tested by the rays reaching it.
+ *
+ * @param rays up to RAY_PACKET_WIDTH rays
+ * @param hits receives the closest hit of each ray
+ * @param tmax distance up to which the rays are cast
+ */
+void OctreeNode::_trace_packet(
+    std::span<const Ray> rays,
+    std::span<RayHit> hits,
+    double tmax
+) const {
+    RayPacket packet(rays, tmax);
+    const int flip = octant_flip(rays[0].direction);
+
+    for (RayHit& hit : hits) {
+        hit = RayHit();
+        hit.distance = tmax;
+    }
+
+    std::array<const OctreeNode*, RAY_STACK_SIZE> stack;
+    size_t size = 0;
+    stack[size++] = this;
+
+    while (size) {
+        const OctreeNode* node = stack[--size];
+
+        uint32_t reached = helpers::packet_box(packet, node->_bounds);
+        if (!reached) continue;
+
+        const OctreeNode* leaf = node->_packs ? node : node->_straddlers;
+        if (leaf) {
+            for (uint32_t lanes = reached; lanes; lanes &= lanes - 1) {
+                const int lane = __builtin_ctz(lanes);
+
+                for (uint32_t i = 0; i < leaf->_pack_count; i++)
+                    helpers::pack_raycast(
+                        rays[lane],
+                        leaf->_packs[i],
+                        hits[lane]
+                    );
+                packet.limit[lane] = hits[lane].distance;
+            }
+            if (leaf == node) continue;
+        }
+
+        for (int i = 7; i >= 0; i--)
+            if (OctreeNode* child = node->_children[i ^ flip])
+                stack[size++] = child;
+    }
+
+    for (RayHit& hit : hits)
+        if (!hit.found()) hit = RayHit();
 }
@@ -0,0 +1,319 @@
+#include "../include/packs.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/contacts.hpp"
+#include "../include/mesh.hpp"
+#include "../include/simd.hpp"
+
+using namespace YAAACD;
+using YAAACD::simd::Batch;
+
+static_assert(PACK_WIDTH % Batch::WIDTH == 0);
+
+// Slightly above Shewchuk's (7 + 56e)e bound for the 3x3 orientation
+// determinant, so that a rejection is never caused by rounding.
+constexpr double PLANE_ERRBOUND =
+    8 * std::numeric_limits<double>::epsilon() / 2;
+
+/**
+ * @brief Bitmask of lanes whose vertices are all strictly on one side of
+ * the plane through p with edge vectors (e1, e2).
+ */
+static uint32_t plane_side(
+    const std::array<Batch, 3>& p,
+    const std::array<Batch, 3>& e1,
+    const std::array<Batch, 3>& e2,
+    const std::array<std::array<Batch, 3>, 3>& vertices
+) {
+    const Batch nx_a = e1[1] * e2[2], nx_b = e1[2] * e2[1];
+    const Batch ny_a = e1[2] * e2[0], ny_b = e1[0] * e2[2];
+    const Batch nz_a = e1[0] * e2[1], nz_b = e1[1] * e2[0];
+
+    const Batch nx = nx_a - nx_b, ny = ny_a - ny_b, nz = nz_a - nz_b;
+    const Batch px = abs(nx_a) + abs(nx_b);
+    const Batch py = abs(ny_a) + abs(ny_b);
+    const Batch pz = abs(nz_a) + abs(nz_b);
+    const Batch bound = Batch::broadcast(PLANE_ERRBOUND);
+    const Batch zero = Batch::broadcast(0);
+
+    uint32_t above = ~0u;
+    uint32_t below = ~0u;
+    for (const std::array<Batch, 3>& vertex : vertices) {
+        const Batch dx = vertex[0] - p[0];
+        const Batch dy = vertex[1] - p[1];
+        const Batch dz = vertex[2] - p[2];
+
+        const Batch distance = dx * nx + dy * ny + dz * nz;
+        const Batch error =
+            bound * (abs(dx) * px + abs(dy) * py + abs(dz) * pz);
+
+        above &= greater(distance, error);
+        below &= greater(zero - distance, error);
+    }
+
+    return above | below;
+}
+
+/**
+ * @brief Return the lanes of a pack that may intersect the triangle.
+ *
+ * Lanes are rejected when all vertices of one triangle lie strictly on one
+ * side of the other triangle's plane (in both directions) or when the
+ * coordinate intervals of the two triangles are disjoint on any axis. Both
+ * filters are conservative: a cleared bit guarantees no intersection, a set
+ * bit still needs the exact test.
+ *
+ * @param triangle triangle to test
+ * @param pack pack of triangles to test against
+ * @return uint32_t bitmask of candidate lanes
+ */
+uint32_t YAAACD::helpers::pack_candidates(
+    const Triangle& triangle,
+    const TrianglePack& pack
+) {
+    std::array<std::array<Batch, 3>, 3> triangle_vertices;
+    std::array<double, 3> lower;
+    std::array<double, 3> upper;
+    for (int axis = 0; axis < 3; axis++) {
+        auto coordinate = [axis](const Vertex& vertex) {
+            return axis == 0 ? vertex.x : (axis == 1 ? vertex.y : vertex.z);
+        };
+        lower[axis] = std::min(
+            {coordinate(triangle[0]),
+             coordinate(triangle[1]),
+             coordinate(triangle[2])}
+        );
+        upper[axis] = std::max(
+            {coordinate(triangle[0]),
+             coordinate(triangle[1]),
+             coordinate(triangle[2])}
+        );
+        for (int k = 0; k < 3; k++)
+            triangle_vertices[k][axis] =
+                Batch::broadcast(coordinate(triangle[k]));
+    }
+
+    std::array<Batch, 3> triangle_e1;
+    std::array<Batch, 3> triangle_e2;
+    for (int axis = 0; axis < 3; axis++) {
+        triangle_e1[axis] =
+            triangle_vertices[1][axis] - triangle_vertices[0][axis];
+        triangle_e2[axis] =
+            triangle_vertices[2][axis] - triangle_vertices[0][axis];
+    }
+
+    uint32_t candidates = 0;
+    for (int offset = 0; offset < PACK_WIDTH; offset += Batch::WIDTH) {
+        std::array<std::array<Batch, 3>, 3> vertices;
+        for (int k = 0; k < 3; k++)
+            for (int axis = 0; axis < 3; axis++)
+                vertices[k][axis] =
+                    Batch::load(&pack.coordinates[k][axis][offset]);
+
+        // Interval overlap of the axis-aligned extents.
+        uint32_t rejected = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            const Batch pack_lower = min(
+                min(vertices[0][axis], vertices[1][axis]),
+                vertices[2][axis]
+            );
+            const Batch pack_upper = max(
+                max(vertices[0][axis], vertices[1][axis]),
+                vertices[2][axis]
+            );
+
+            rejected |= greater(pack_lower, Batch::broadcast(upper[axis]));
+            rejected |= greater(Batch::broadcast(lower[axis]), pack_upper);
+        }
+
+        // Pack triangles against the plane of the triangle...
+        rejected |= plane_side(
+            triangle_vertices[0],
+            triangle_e1,
+            triangle_e2,
+            vertices
+        );
+
+        // ...and the triangle against the plane of every pack triangle.
+        std::array<Batch, 3> e1;
+        std::array<Batch, 3> e2;
+        for (int axis = 0; axis < 3; axis++) {
+            e1[axis] = vertices[1][axis] - vertices[0][axis];
+            e2[axis] = vertices[2][axis] - vertices[0][axis];
+        }
+        rejected |= plane_side(vertices[0], e1, e2, triangle_vertices);
+
+        candidates |= (~rejected & ((1u << Batch::WIDTH) - 1)) << offset;
+    }
+
+    return candidates & ((1u << pack.size) - 1);
+}
+
+/**
+ * @brief Check if a triangle intersects any triangle of a pack.
+ *
+ * @param triangle triangle to test
+ * @param pack pack of triangles to test against
+ * @return true if any lane intersects the triangle
+ */
+bool YAAACD::helpers::pack_intersects(
+    const Triangle& triangle,
+    const TrianglePack& pack
+) {
+    uint32_t candidates = pack_candidates(triangle, pack);
+
+    while (candidates) {
+        const int lane = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+
+        if (triangles_intersect(triangle, pack.triangle(lane))) return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Report every triangle of a pack intersecting a triangle.
+ *
+ * @param triangle triangle to test
+ * @param id id of the triangle
+ * @param pack pack of triangles to test against
+ * @param sink sink receiving the contacts
+ * @param swapped true if the pack holds triangles of the queried object, so
+ * that the ids of each contact must be swapped
+ * @return false if the sink asked to stop
+ */
+bool YAAACD::helpers::pack_contacts(
+    const Triangle& triangle,
+    uint32_t id,
+    const TrianglePack& pack,
+    ContactSink& sink,
+    bool swapped
+) {
+    uint32_t candidates = pack_candidates(triangle, pack);
+
+    while (candidates) {
+        const int lane = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+
+        const Triangle other = pack.triangle(lane);
+        if (!triangles_intersect(triangle, other)) continue;
+
+        const bool go_on =
+            swapped ? sink.report(pack.ids[lane], id, other, triangle)
+                    : sink.report(id, pack.ids[lane], triangle, other);
+        if (!go_on) return false;
+    }
+
+    return true;
+}
+
+bool YAAACD::helpers::packs_intersect(
+    const std::vector<Triangle>& triangles,
+    const std::vector<TrianglePack>& packs
+) {
+    for (const Triangle& triangle : triangles)
+        for (const TrianglePack& pack : packs)
+            if (pack_intersects(triangle, pack)) return true;
+
+    return false;
+}
+
+Triangle TrianglePack::triangle(int lane) const {
+    Triangle triangle;
+    for (int k = 0; k < 3; k++)
+        triangle[k] = Vertex(
+            this->coordinates[k][0][lane],
+            this->coordinates[k][1][lane],
+            this->coordinates[k][2][lane]
+        );
+
+    return triangle;
+}
+
+/**
+ * @brief Store a triangle in one lane of a pack.
+ */
+static void fill_lane(
+    TrianglePack& pack,
+    uint32_t lane,
+    uint32_t id,
+    const Triangle& triangle
+) {
+    pack.ids[lane] = id;
+    for (int k = 0; k < 3; k++) {
+        pack.coordinates[k][0][lane] = triangle[k].x;
+        pack.coordinates[k][1][lane] = triangle[k].y;
+        pack.coordinates[k][2][lane] = triangle[k].z;
+    }
+}
+
+/**
+ * @brief Fill consecutive packs with the given triangles of a mesh.
+ *
+ * @param packs first of the pack_count(count) packs to fill
+ * @param mesh mesh holding the triangles
+ * @param indices indices of the triangles to pack
+ * @param count number of indices
+ */
+void YAAACD::pack_triangles(
+    TrianglePack* packs,
+    const IndexedMesh& mesh,
+    const uint32_t* indices,
+    size_t count
+) {
+    for (size_t first = 0; first < count; first += PACK_WIDTH) {
+        TrianglePack& pack = *packs++;
+        pack.size = std::min<size_t>(PACK_WIDTH, count - first);
+
+        for (uint32_t lane = 0; lane < PACK_WIDTH; lane++) {
+            const uint32_t id =
+                indices[first + std::min(lane, pack.size - 1)];
+            fill_lane(pack, lane, id, mesh.triangle(id));
+        }
+    }
+}
+
+/**
+ * @brief Append packs holding the given triangles of a mesh to a pack vector.
+ *
+ * @param packs vector to append to
+ * @param mesh mesh holding the triangles
+ * @param indices indices of the triangles to pack
+ * @param count number of indices
+ */
+void YAAACD::pack_triangles(
+    std::vector<TrianglePack>& packs,
+    const IndexedMesh& mesh,
+    const uint32_t* indices,
+    size_t count
+) {
+    const size_t first = packs.size();
+    packs.resize(first + pack_count(count));
+    pack_triangles(packs.data() + first, mesh, indices, count);
+}
+
+std::vector<TrianglePack> YAAACD::pack_triangles(
+    const std::vector<Triangle>& triangles
+) {
+    std::vector<TrianglePack> packs;
+
+    for (size_t first = 0; first < triangles.size(); first += PACK_WIDTH) {
+        TrianglePack& pack = packs.emplace_back();
+        pack.size = std::min<size_t>(PACK_WIDTH, triangles.size() - first);
+
+        for (uint32_t lane = 0; lane < PACK_WIDTH; lane++) {
+            const uint32_t id = first + std::min(lane, pack.size - 1);
+            fill_lane(pack, lane, id, triangles[id]);
+        }
+    }
+
+    return packs;
+}
@@ -0,0 +1,296 @@
+#include "../include/partition.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../include/common.hpp"
+
+constexpr int RIGHT = 0b100;
+constexpr int TOP = 0b010;
+constexpr int FRONT = 0b001;
+
+using namespace YAAACD;
+
+/**
+ * @brief Construct an empty (inverted) AABB that extends to any box.
+ */
+AABB::AABB() {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    this->lower = Vertex(inf, inf, inf);
+    this->upper = Vertex(-inf, -inf, -inf);
+}
+
+/**
+ * @brief Construct the AABB of a triangle.
+ *
+ * @param triangle triangle to enclose
+ */
+AABB::AABB(const Triangle& triangle) {
+    this->lower = Vertex(
+        std::min({triangle[0].x, triangle[1].x, triangle[2].x}),
+        std::min({triangle[0].y, triangle[1].y, triangle[2].y}),
+        std::min({triangle[0].z, triangle[1].z, triangle[2].z})
+    );
+    this->upper = Vertex(
+        std::max({triangle[0].x, triangle[1].x, triangle[2].x}),
+        std::max({triangle[0].y, triangle[1].y, triangle[2].y}),
+        std::max({triangle[0].z, triangle[1].z, triangle[2].z})
+    );
+}
+
+void AABB::extend(const AABB& box) {
+    this->lower = Vertex(
+        std::min(this->lower.x, box.lower.x),
+        std::min(this->lower.y, box.lower.y),
+        std::min(this->lower.z, box.lower.z)
+    );
+    this->upper = Vertex(
+        std::max(this->upper.x, box.upper.x),
+        std::max(this->upper.y, box.upper.y),
+        std::max(this->upper.z, box.upper.z)
+    );
+}
+
+/**
+ * @brief Check if two boxes overlap on every axis.
+ */
+bool AABB::overlaps(const AABB& box) const {
+    return this->lower.x <= box.upper.x && box.lower.x <= this->upper.x &&
+           this->lower.y <= box.upper.y && box.lower.y <= this->upper.y &&
+           this->lower.z <= box.upper.z && box.lower.z <= this->upper.z;
+}
+
+Vertex AABB::center() const {
+    return Vertex(
+        (this->lower.x + this->upper.x) / 2,
+        (this->lower.y + this->upper.y) / 2,
+        (this->lower.z + this->upper.z) / 2
+    );
+}
+
+/**
+ * @brief Surface area of the box, 0 for an empty box.
+ */
+double AABB::area() const {
+    if (this->lower.x > this->upper.x) return 0;
+
+    const double x = this->upper.x - this->lower.x;
+    const double y = this->upper.y - this->lower.y;
+    const double z = this->upper.z - this->lower.z;
+
+    return 2 * (x * y + y * z + z * x);
+}
+
+/**
+ * @brief Compute the AABB of every triangle.
+ *
+ * @param triangles triangles to enclose
+ * @return std::vector<AABB> one box per triangle
+ */
+std::vector<AABB> YAAACD::triangle_bounds(
+    const std::vector<Triangle>& triangles
+) {
+    std::vector<AABB> boxes;
+    boxes.reserve(triangles.size());
+    for (const Triangle& triangle : triangles) boxes.emplace_back(triangle);
+
+    return boxes;
+}
+
+/**
+ * @brief Octant of the node center that contains the center of a box.
+ */
+static int octant(const AABB& box, const Vertex& center) {
+    const Vertex point = box.center();
+
+    return (point.x > center.x ? RIGHT : 0) | (point.y > center.y ? TOP : 0) |
+           (point.z > center.z ? FRONT : 0);
+}
+
+/**
+ * @brief Reorder a range of triangle indices by octant, in place.
+ *
+ * Every triangle goes to exactly one octant, the one containing the center
+ * of its AABB, so no member is lost or duplicated. A single classification
+ * pass computes the octant sizes together with the bounds of the members of
+ * each octant, then the range is permuted in place (American flag sort).
+ *
+ * @param indices range of triangle indices to partition
+ * @param count number of indices in the range
+ * @param boxes AABBs of all triangles, indexed by triangle index
+ * @param center point splitting the node into octants
+ * @return OctantSplit octant ranges and bounds
+ */
+OctantSplit YAAACD::helpers::partition_octants(
+    uint32_t* indices,
+    uint32_t count,
+    const std::vector<AABB>& boxes,
+    const Vertex& center
+) {
+    OctantSplit split;
+    std::array<uint32_t, 8> sizes = {0};
+
+    for (uint32_t i = 0; i < count; i++) {
+        const AABB& box = boxes[indices[i]];
+        const int index = octant(box, center);
+
+        sizes[index]++;
+        split.bounds[index].extend(box);
+    }
+
+    for (int i = 0; i < 8; i++)
+        split.offsets[i + 1] = split.offsets[i] + sizes[i];
+
+    std::array<uint32_t, 8> next;
+    std::copy(split.offsets.begin(), split.offsets.end() - 1, next.begin());
+
+    for (int i = 0; i < 8; i++)
+        while (next[i] < split.offsets[i + 1]) {
+            const int index = octant(boxes[indices[next[i]]], center);
+
+            if (index == i)
+                next[i]++;
+            else
+                std::swap(indices[next[i]], indices[next[index]++]);
+        }
+
+    return split;
+}
+
+/**
+ * @brief Check if a box lies in the loose octant of a cell that holds its
+ * center.
+ *
+ * @param box box to check
+ * @param cell box of the node
+ * @param center center of the cell
+ * @param margin growth of each side of the octants
+ */
+static bool fits_loose(
+    const AABB& box,
+    const AABB& cell,
+    const Vertex& center,
+    const Vertex& margin
+) {
+    for (double Vertex::*axis : {&Vertex::x, &Vertex::y, &Vertex::z}) {
+        const bool right =
+            (box.lower.*axis + box.upper.*axis) / 2 > center.*axis;
+        const double low = right ? center.*axis : cell.lower.*axis;
+        const double high = right ? cell.upper.*axis : center.*axis;
+
+        if (box.lower.*axis < low - margin.*axis ||
+            box.upper.*axis > high + margin.*axis)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reorder a range of triangle indices for a loose octree node.
+ *
+ * Every octant of the cell is grown by `looseness` around its center. The
+ * members whose box does not fit in the loose octant holding its center
+ * stay with the node and are moved to the front of the range; the others
+ * are partitioned by partition_octants(). Straddling members thus no longer
+ * stretch the bounds of the octant they were assigned to.
+ *
+ * @param indices range of triangle indices to partition
+ * @param count number of indices in the range
+ * @param boxes AABBs of all triangles, indexed by triangle index
+ * @param cell box of the node
+ * @param looseness growth factor of the octants, at least 1
+ * @return OctantSplit straddlers followed by the octant ranges
+ */
+OctantSplit YAAACD::helpers::partition_loose(
+    uint32_t* indices,
+    uint32_t count,
+    const std::vector<AABB>& boxes,
+    const AABB& cell,
+    double looseness
+) {
+    const Vertex center = cell.center();
+    const double grow = (looseness - 1) / 4;
+    const Vertex margin(
+        grow * (cell.upper.x - cell.lower.x),
+        grow * (cell.upper.y - cell.lower.y),
+        grow * (cell.upper.z - cell.lower.z)
+    );
+
+    uint32_t* fitting =
+        std::partition(indices, indices + count, [&](uint32_t index) {
+            return !fits_loose(boxes[index], cell, center, margin);
+        });
+    const uint32_t straddlers = fitting - indices;
+
+    OctantSplit split =
+        partition_octants(fitting, count - straddlers, boxes, center);
+    for (uint32_t& offset : split.offsets) offset += straddlers;
+
+    split.straddlers = straddlers;
+    for (uint32_t i = 0; i < straddlers; i++)
+        split.straddler_bounds.extend(boxes[indices[i]]);
+
+    return split;
+}
+
+/**
+ * @brief Box of one octant of a cell, split at the cell center.
+ *
+ * @param cell box to split
+ * @param octant octant to return
+ * @return AABB the octant's box
+ */
+AABB YAAACD::helpers::octant_cell(const AABB& cell, int octant) {
+    const Vertex center = cell.center();
+    AABB box;
+    box.lower = Vertex(
+        octant & RIGHT ? center.x : cell.lower.x,
+        octant & TOP ? center.y : cell.lower.y,
+        octant & FRONT ? center.z : cell.lower.z
+    );
+    box.upper = Vertex(
+        octant & RIGHT ? cell.upper.x : center.x,
+        octant & TOP ? cell.upper.y : center.y,
+        octant & FRONT ? cell.upper.z : center.z
+    );
+
+    return box;
+}
+
+/**
+ * @brief Check if a node is large enough to be split.
+ *
+ * @param count number of members of the node
+ * @param total number of triangles in the whole tree
+ * @param level depth of the node
+ * @return true if the node should be partitioned
+ */
+bool YAAACD::helpers::should_split(uint32_t count, size_t total, int level) {
+    return level < DEPTH_LIMIT && count >= MIN_MEMBERS &&
+           count > MIN_SHARE * total;
+}
+
+/**
+ * @brief Check if a partition actually separates the members.
+ *
+ * @param split partition of the node's members
+ * @param count number of members of the node
+ * @param ratio share of the members no octant may keep
+ * @return true if no octant keeps `ratio` of the members
+ */
+bool YAAACD::helpers::split_effective(
+    const OctantSplit& split,
+    uint32_t count,
+    double ratio
+) {
+    for (int i = 0; i < 8; i++)
+        if (split.count(i) >= ratio * count) return false;
+
+    return true;
+}
@@ -0,0 +1,345 @@
+#include "../include/ray.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "../include/common.hpp"
+#include "../include/packs.hpp"
+#include "../include/simd.hpp"
+
+using namespace YAAACD;
+using YAAACD::simd::Batch;
+
+static_assert(RAY_PACKET_WIDTH % Batch::WIDTH == 0);
+
+/**
+ * @brief Pack rays, leaving the unused lanes with a negative limit.
+ *
+ * @param rays up to RAY_PACKET_WIDTH rays
+ * @param tmax distance up to which the rays are looked for
+ */
+RayPacket::RayPacket(std::span<const Ray> rays, double tmax) {
+    for (int lane = 0; lane < RAY_PACKET_WIDTH; lane++) {
+        const bool used = lane < static_cast<int>(rays.size());
+        const Ray ray = used ? rays[lane] : Ray();
+        const Vertex inverse =
+            used ? helpers::ray_inverse(ray) : Vertex(1, 1, 1);
+
+        this->origin[0][lane] = ray.origin.x;
+        this->origin[1][lane] = ray.origin.y;
+        this->origin[2][lane] = ray.origin.z;
+        this->inverse[0][lane] = inverse.x;
+        this->inverse[1][lane] = inverse.y;
+        this->inverse[2][lane] = inverse.z;
+        this->limit[lane] = used ? tmax : -1;
+    }
+}
+
+/**
+ * @brief Component-wise inverse of the direction of a ray, as used by the
+ * slab tests.
+ *
+ * Zero components are mapped to the largest finite double with the same
+ * sign rather than to infinity, so that a ray lying in the plane of a slab
+ * gives 0 * inverse = 0 instead of NaN.
+ *
+ * @param ray ray to invert
+ * @return Vertex inverse direction
+ */
+Vertex YAAACD::helpers::ray_inverse(const Ray& ray) {
+    auto invert = [](double component) {
+        return component != 0
+                   ? 1 / component
+                   : std::copysign(
+                         std::numeric_limits<double>::max(),
+                         component
+                     );
+    };
+
+    return Vertex(
+        invert(ray.direction.x),
+        invert(ray.direction.y),
+        invert(ray.direction.z)
+    );
+}
+
+/**
+ * @brief Slab test of a ray against one box.
+ *
+ * @param ray ray to test
+ * @param inverse inverse direction of the ray, see ray_inverse()
+ * @param box box to test against
+ * @param tmax distance up to which the ray is tested
+ * @param entry set to the distance at which the ray enters the box, 0 if
+ * the origin is inside
+ * @return true if the ray meets the box between 0 and `tmax`
+ */
+bool YAAACD::helpers::ray_box(
+    const Ray& ray,
+    const Vertex& inverse,
+    const BoundingBox& box,
+    double tmax,
+    double& entry
+) {
+    const double origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const double scale[3] = {inverse.x, inverse.y, inverse.z};
+    const double lower[3] = {box.lower().x, box.lower().y, box.lower().z};
+    const double upper[3] = {box.upper().x, box.upper().y, box.upper().z};
+
+    double near = 0;
+    double far = tmax;
+    for (int axis = 0; axis < 3; axis++) {
+        const double t1 = (lower[axis] - origin[axis]) * scale[axis];
+        const double t2 = (upper[axis] - origin[axis]) * scale[axis];
+
+        near = std::max(near, std::min(t1, t2));
+        far = std::min(far, std::max(t1, t2));
+    }
+
+    entry = near;
+    return near <= far;
+}
+
+/**
+ * @brief Slab test of a ray against a pack of up to 8 boxes at once.
+ *
+ * @param ray ray to test
+ * @param inverse inverse direction of the ray, see ray_inverse()
+ * @param boxes packed boxes; missing (inverted) boxes are never hit
+ * @param tmax distance up to which the ray is tested
+ * @param entries receives the entry distance of each of the 8 boxes
+ * @return uint32_t bitmask of the boxes met between 0 and `tmax`
+ */
+uint32_t YAAACD::helpers::ray_boxes(
+    const Ray& ray,
+    const Vertex& inverse,
+    const BoxPack& boxes,
+    double tmax,
+    double* entries
+) {
+    const Batch origin[3] = {
+        Batch::broadcast(ray.origin.x),
+        Batch::broadcast(ray.origin.y),
+        Batch::broadcast(ray.origin.z)
+    };
+    const Batch scale[3] = {
+        Batch::broadcast(inverse.x),
+        Batch::broadcast(inverse.y),
+        Batch::broadcast(inverse.z)
+    };
+
+    uint32_t hits = 0;
+    for (int offset = 0; offset < 8; offset += Batch::WIDTH) {
+        Batch near = Batch::broadcast(0);
+        Batch far = Batch::broadcast(tmax);
+        for (int axis = 0; axis < 3; axis++) {
+            const Batch t1 =
+                (Batch::load(&boxes.lower[axis][offset]) - origin[axis]) *
+                scale[axis];
+            const Batch t2 =
+                (Batch::load(&boxes.upper[axis][offset]) - origin[axis]) *
+                scale[axis];
+
+            near = max(near, min(t1, t2));
+            far = min(far, max(t1, t2));
+        }
+        near.store(entries + offset);
+
+        const uint32_t missed = greater(near, far) |
+                                greater(
+                                    Batch::load(&boxes.lower[0][offset]),
+                                    Batch::load(&boxes.upper[0][offset])
+                                );
+        hits |= (~missed & ((1u << Batch::WIDTH) - 1)) << offset;
+    }
+
+    return hits;
+}
+
+/**
+ * @brief Slab test of a packet of rays against one box.
+ *
+ * @param packet rays to test, each up to its own limit
+ * @param box box to test against
+ * @return uint32_t bitmask of the rays meeting the box
+ */
+uint32_t YAAACD::helpers::packet_box(
+    const RayPacket& packet,
+    const BoundingBox& box
+) {
+    const Batch lower[3] = {
+        Batch::broadcast(box.lower().x),
+        Batch::broadcast(box.lower().y),
+        Batch::broadcast(box.lower().z)
+    };
+    const Batch upper[3] = {
+        Batch::broadcast(box.upper().x),
+        Batch::broadcast(box.upper().y),
+        Batch::broadcast(box.upper().z)
+    };
+
+    uint32_t hits = 0;
+    for (int offset = 0; offset < RAY_PACKET_WIDTH; offset += Batch::WIDTH) {
+        Batch near = Batch::broadcast(0);
+        Batch far = Batch::load(&packet.limit[offset]);
+        for (int axis = 0; axis < 3; axis++) {
+            const Batch origin = Batch::load(&packet.origin[axis][offset]);
+            const Batch scale = Batch::load(&packet.inverse[axis][offset]);
+            const Batch t1 = (lower[axis] - origin) * scale;
+            const Batch t2 = (upper[axis] - origin) * scale;
+
+            near = max(near, min(t1, t2));
+            far = min(far, max(t1, t2));
+        }
+
+        const uint32_t missed = greater(near, far);
+        hits |= (~missed & ((1u << Batch::WIDTH) - 1)) << offset;
+    }
+
+    return hits;
+}
+
+/* RAY-TRIANGLE
+ * Both kernels below are Möller-Trumbore with the same operations in the
+ * same order, so the packed kernel finds exactly the hits of the scalar one.
+ * This holds because this file is built with -ffp-contract=off; fused
+ * multiply-adds would round the two kernels differently.
+ * A hit is accepted when its distance is at least 0 and strictly below the
+ * distance of the hit recorded so far.
+ */
+
+/**
+ * @brief Record the hit of a ray with a triangle if it is closer than the
+ * current one.
+ *
+ * @param ray ray to test
+ * @param triangle triangle to test against
+ * @param id id stored in the hit
+ * @param hit current hit; its distance is the limit of the test
+ * @return true if `hit` was updated
+ */
+bool YAAACD::helpers::ray_triangle(
+    const Ray& ray,
+    const Triangle& triangle,
+    uint32_t id,
+    RayHit& hit
+) {
+    const Vertex& a = triangle[0];
+    const Vertex& d = ray.direction;
+
+    const double e1x = triangle[1].x - a.x;
+    const double e1y = triangle[1].y - a.y;
+    const double e1z = triangle[1].z - a.z;
+    const double e2x = triangle[2].x - a.x;
+    const double e2y = triangle[2].y - a.y;
+    const double e2z = triangle[2].z - a.z;
+
+    const double px = d.y * e2z - d.z * e2y;
+    const double py = d.z * e2x - d.x * e2z;
+    const double pz = d.x * e2y - d.y * e2x;
+    const double det = e1x * px + e1y * py + e1z * pz;
+    if (!(std::fabs(det) > 0)) return false;
+
+    const double sx = ray.origin.x - a.x;
+    const double sy = ray.origin.y - a.y;
+    const double sz = ray.origin.z - a.z;
+    const double u = (sx * px + sy * py + sz * pz) / det;
+
+    const double qx = sy * e1z - sz * e1y;
+    const double qy = sz * e1x - sx * e1z;
+    const double qz = sx * e1y - sy * e1x;
+    const double v = (d.x * qx + d.y * qy + d.z * qz) / det;
+    const double t = (e2x * qx + e2y * qy + e2z * qz) / det;
+
+    if (u < 0 || v < 0 || u + v > 1 || t < 0 || !(t < hit.distance))
+        return false;
+
+    hit = {t, id, u, v};
+    return true;
+}
+
+/**
+ * @brief Record the closest hit of a ray with the triangles of a pack if it
+ * is closer than the current one.
+ *
+ * @param ray ray to test
+ * @param pack pack of triangles to test against
+ * @param hit current hit; its distance is the limit of the test
+ * @return true if `hit` was updated
+ */
+bool YAAACD::helpers::pack_raycast(
+    const Ray& ray,
+    const TrianglePack& pack,
+    RayHit& hit
+) {
+    const Batch origin[3] = {
+        Batch::broadcast(ray.origin.x),
+        Batch::broadcast(ray.origin.y),
+        Batch::broadcast(ray.origin.z)
+    };
+    const Batch d[3] = {
+        Batch::broadcast(ray.direction.x),
+        Batch::broadcast(ray.direction.y),
+        Batch::broadcast(ray.direction.z)
+    };
+    const Batch zero = Batch::broadcast(0);
+    const Batch one = Batch::broadcast(1);
+    const Batch limit = Batch::broadcast(hit.distance);
+
+    double distances[PACK_WIDTH];
+    double us[PACK_WIDTH];
+    double vs[PACK_WIDTH];
+    uint32_t accepted = 0;
+    for (int offset = 0; offset < PACK_WIDTH; offset += Batch::WIDTH) {
+        Batch a[3];
+        Batch e1[3];
+        Batch e2[3];
+        for (int axis = 0; axis < 3; axis++) {
+            a[axis] = Batch::load(&pack.coordinates[0][axis][offset]);
+            e1[axis] =
+                Batch::load(&pack.coordinates[1][axis][offset]) - a[axis];
+            e2[axis] =
+                Batch::load(&pack.coordinates[2][axis][offset]) - a[axis];
+        }
+
+        const Batch px = d[1] * e2[2] - d[2] * e2[1];
+        const Batch py = d[2] * e2[0] - d[0] * e2[2];
+        const Batch pz = d[0] * e2[1] - d[1] * e2[0];
+        const Batch det = e1[0] * px + e1[1] * py + e1[2] * pz;
+
+        const Batch sx = origin[0] - a[0];
+        const Batch sy = origin[1] - a[1];
+        const Batch sz = origin[2] - a[2];
+        const Batch u = (sx * px + sy * py + sz * pz) / det;
+
+        const Batch qx = sy * e1[2] - sz * e1[1];
+        const Batch qy = sz * e1[0] - sx * e1[2];
+        const Batch qz = sx * e1[1] - sy * e1[0];
+        const Batch v = (d[0] * qx + d[1] * qy + d[2] * qz) / det;
+        const Batch t = (e2[0] * qx + e2[1] * qy + e2[2] * qz) / det;
+
+        const uint32_t rejected = greater(zero, u) | greater(zero, v) |
+                                  greater(u + v, one) | greater(zero, t);
+        const uint32_t valid = greater(abs(det), zero) & greater(limit, t);
+
+        t.store(distances + offset);
+        u.store(us + offset);
+        v.store(vs + offset);
+        accepted |= (valid & ~rejected & ((1u << Batch::WIDTH) - 1))
+                    << offset;
+    }
+    accepted &= (1u << pack.size) - 1;
+    if (!accepted) return false;
+
+    int best = __builtin_ctz(accepted);
+    for (uint32_t rest = accepted & (accepted - 1); rest; rest &= rest - 1) {
+        const int lane = __builtin_ctz(rest);
+        if (distances[lane] < distances[best]) best = lane;
+    }
+
+    hit = {distances[best], pack.ids[best], us[best], vs[best]};
+    return true;
+}
@@ -0,0 +1,173 @@
+#include "../include/scheduler.hpp"
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using namespace YAAACD;
+
+// Identifies the pool worker running on the current thread, if any.
+static thread_local const TaskPool* current_pool = nullptr;
+static thread_local size_t current_index = 0;
+
+/**
+ * @brief Construct a new TaskPool object and start its workers.
+ *
+ * @param threads number of worker threads; with 0 workers every task runs
+ * on the thread that waits for it
+ */
+TaskPool::TaskPool(size_t threads) {
+    for (size_t i = 0; i <= threads; i++)
+        this->_queues.push_back(std::make_unique<Queue>());
+
+    for (size_t i = 0; i < threads; i++)
+        this->_threads.emplace_back(&TaskPool::_worker, this, i);
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->_sleep_mutex);
+        this->_stop = true;
+    }
+    this->_wake.notify_all();
+
+    for (std::thread& thread : this->_threads) thread.join();
+}
+
+size_t TaskPool::_current_queue() const {
+    return current_pool == this ? current_index : this->_threads.size();
+}
+
+/**
+ * @brief Schedule a task as part of a group.
+ *
+ * Tasks submitted by a worker go to the back of its own deque, tasks from
+ * any other thread to the shared injection queue.
+ *
+ * @param group group the task belongs to
+ * @param task task to run
+ */
+void TaskPool::submit(TaskGroup& group, Task task) {
+    group._pending.fetch_add(1, std::memory_order_relaxed);
+
+    Queue& queue = *this->_queues[this->_current_queue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.entries.push_back({std::move(task), &group});
+    }
+    this->_queued.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(this->_sleep_mutex);
+    }
+    this->_wake.notify_one();
+}
+
+/**
+ * @brief Block until every task of the group has finished.
+ *
+ * The calling thread executes queued tasks (of any group) while waiting.
+ * Tasks still run to the end if another task of their group threw; the
+ * group can be reused once wait() returned or threw.
+ *
+ * @param group group to wait for
+ * @throw the first exception thrown by a task of the group
+ */
+void TaskPool::wait(TaskGroup& group) {
+    const size_t index = this->_current_queue();
+
+    while (!group.done()) {
+        if (this->_try_run(index)) continue;
+
+        std::unique_lock<std::mutex> lock(this->_sleep_mutex);
+        this->_wake.wait(lock, [&]() {
+            return group.done() || this->_queued.load() > 0;
+        });
+    }
+
+    if (group._failed.load(std::memory_order_acquire)) {
+        std::exception_ptr error = std::exchange(group._error, nullptr);
+        group._failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskPool::_worker(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    while (!this->_stop) {
+        if (this->_try_run(index)) continue;
+
+        std::unique_lock<std::mutex> lock(this->_sleep_mutex);
+        this->_wake.wait(lock, [&]() {
+            return this->_stop || this->_queued.load() > 0;
+        });
+    }
+}
+
+bool TaskPool::_try_run(size_t index) {
+    Entry entry;
+    if (!this->_pop(index, entry) && !this->_steal(index, entry))
+        return false;
+
+    this->_queued.fetch_sub(1, std::memory_order_relaxed);
+    this->_run(entry);
+
+    return true;
+}
+
+bool TaskPool::_pop(size_t index, Entry& entry) {
+    Queue& queue = *this->_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.entries.empty()) return false;
+
+    // Workers run their own work depth-first; the injection queue is FIFO.
+    if (index < this->_threads.size()) {
+        entry = std::move(queue.entries.back());
+        queue.entries.pop_back();
+    } else {
+        entry = std::move(queue.entries.front());
+        queue.entries.pop_front();
+    }
+
+    return true;
+}
+
+bool TaskPool::_steal(size_t index, Entry& entry) {
+    const size_t count = this->_queues.size();
+
+    for (size_t offset = 1; offset < count; offset++) {
+        Queue& queue = *this->_queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.entries.empty()) continue;
+
+        entry = std::move(queue.entries.front());
+        queue.entries.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+void TaskPool::_run(Entry& entry) {
+    try {
+        entry.task();
+    } catch (...) {
+        // Only the first error is kept, the group counts the task as done
+        // either way so that wait() returns.
+        if (!entry.group->_failed.exchange(true, std::memory_order_acq_rel))
+            entry.group->_error = std::current_exception();
+    }
+
+    if (entry.group->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        {
+            std::lock_guard<std::mutex> lock(this->_sleep_mutex);
+        }
+        this->_wake.notify_all();
+    }
+}
@@ -0,0 +1,194 @@
+#include "../include/trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+using namespace YAAACD;
+using namespace YAAACD::trace;
+
+namespace {
+
+/**
+ * @brief Slot of a ring. Its fields are atomics so that a dump can read a
+ * slot while the owning thread overwrites it; started tells the dump when
+ * that happened.
+ */
+struct Slot {
+    std::atomic<const char*> name = nullptr;
+    std::atomic<uint64_t> start = 0;
+    std::atomic<uint64_t> duration = 0;
+};
+
+/**
+ * @brief Ring of the spans of one thread. Only the owning thread writes the
+ * slots, `started` and `written`: `started` counts the spans whose slot is
+ * being written, `written` every span ever recorded, so the ring holds the
+ * last min(written, TRACE_BUFFER_SIZE) of them. clear() only moves
+ * `cleared`, the first span still to dump, under the registry mutex.
+ */
+struct Buffer {
+    std::array<Slot, TRACE_BUFFER_SIZE> slots;
+    std::atomic<uint64_t> started = 0;
+    std::atomic<uint64_t> written = 0;
+    std::atomic<uint64_t> cleared = 0;
+    uint32_t thread = 0;
+};
+
+/**
+ * @brief Buffers of every thread that recorded a span. Buffers are shared
+ * with their thread, so they outlive threads that exited before the dump.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry registry;
+    return registry;
+}
+
+Buffer& local_buffer() {
+    thread_local const std::shared_ptr<Buffer> buffer = []() {
+        auto buffer = std::make_shared<Buffer>();
+
+        Registry& all = registry();
+        std::lock_guard<std::mutex> lock(all.mutex);
+        buffer->thread = all.buffers.size() + 1;
+        all.buffers.push_back(buffer);
+
+        return buffer;
+    }();
+
+    return *buffer;
+}
+
+}  // namespace
+
+/**
+ * @brief Current time of the steady clock, in nanoseconds. On Linux this is
+ * CLOCK_MONOTONIC, the clock of Chrome and Perfetto traces, so spans line up
+ * with the other tracks of a merged trace.
+ */
+uint64_t YAAACD::trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+    )
+        .count();
+}
+
+/**
+ * @brief Record a span of the calling thread. Lock-free once the thread
+ * recorded its first span.
+ *
+ * @param name name of the span, must outlive the trace (a string literal)
+ * @param start start time, from now()
+ * @param end end time, from now()
+ */
+void YAAACD::trace::record(const char* name, uint64_t start, uint64_t end) {
+    Buffer& buffer = local_buffer();
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+
+    Slot& slot = buffer.slots[index % TRACE_BUFFER_SIZE];
+
+    // Announce the overwrite before touching the slot, as in a seqlock.
+    buffer.started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end - start, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Write the recorded spans as a Chrome trace (JSON object format),
+ * which chrome://tracing and Perfetto open directly.
+ *
+ * Spans are complete ("X") events of process 1, with one track per
+ * recording thread and timestamps in microseconds. Spans overwritten while
+ * the dump runs are skipped, so other threads may keep recording.
+ *
+ * @param out stream to write to
+ */
+void YAAACD::trace::write_chrome_json(std::ostream& out) {
+    Registry& all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out.setf(std::ios::fixed, std::ios::floatfield);
+    out.precision(3);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<Event> events;
+
+    for (const std::shared_ptr<Buffer>& buffer : all.buffers) {
+        const uint64_t cleared =
+            buffer->cleared.load(std::memory_order_relaxed);
+        const uint64_t end = buffer->written.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(
+            end > TRACE_BUFFER_SIZE ? end - TRACE_BUFFER_SIZE : 0,
+            cleared
+        );
+
+        events.clear();
+        for (uint64_t i = begin; i < end; i++) {
+            const Slot& slot = buffer->slots[i % TRACE_BUFFER_SIZE];
+            events.push_back({
+                slot.name.load(std::memory_order_relaxed),
+                slot.start.load(std::memory_order_relaxed),
+                slot.duration.load(std::memory_order_relaxed),
+            });
+        }
+
+        // The owning thread may have kept recording over the oldest spans;
+        // any slot it started to overwrite is skipped.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t latest =
+            buffer->started.load(std::memory_order_relaxed);
+        const uint64_t overwritten =
+            latest > TRACE_BUFFER_SIZE ? latest - TRACE_BUFFER_SIZE : 0;
+        const size_t skip = std::min<uint64_t>(
+            events.size(),
+            overwritten > begin ? overwritten - begin : 0
+        );
+
+        for (size_t i = skip; i < events.size(); i++) {
+            const Event& event = events[i];
+
+            out << (first ? "" : ",") << "\n{\"name\":\"" << event.name
+                << "\",\"cat\":\"yaaacd\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << buffer->thread << ",\"ts\":" << event.start / 1e3
+                << ",\"dur\":" << event.duration / 1e3 << "}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ * @brief Drop every recorded span. Spans recorded concurrently may survive.
+ * The rings are left to their threads: only the first span to dump moves.
+ */
+void YAAACD::trace::clear() {
+    Registry& all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+
+    for (const std::shared_ptr<Buffer>& buffer : all.buffers)
+        buffer->cleared.store(
+            buffer->written.load(std::memory_order_acquire),
+            std::memory_order_relaxed
+        );
+}
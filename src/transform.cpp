@@ -0,0 +1,193 @@
+#include "../include/transform.hpp"
+
+#include <array>
+#include <cmath>
+
+#include "../include/common.hpp"
+
+using namespace YAAACD;
+
+/**
+ * @brief Construct a new Transform object.
+ *
+ * @param rotation rotation matrix, row-major; must be orthonormal
+ * @param translation translation applied after the rotation
+ */
+Transform::Transform(const Rotation& rotation, const Vertex& translation)
+    : rotation(rotation), translation(translation) {}
+
+/**
+ * @brief Build a rotation about an axis through the origin (Rodrigues'
+ * formula), optionally followed by a translation.
+ *
+ * @param axis rotation axis, need not be normalized
+ * @param angle rotation angle in radians, counter-clockwise around the axis
+ * @param translation translation applied after the rotation
+ * @return Transform the transformation
+ */
+Transform Transform::rotation_about(
+    const Vertex& axis,
+    double angle,
+    const Vertex& translation
+) {
+    const double length =
+        std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+    const double x = axis.x / length;
+    const double y = axis.y / length;
+    const double z = axis.z / length;
+    const double c = std::cos(angle);
+    const double s = std::sin(angle);
+    const double t = 1 - c;
+
+    const Rotation rotation = {{
+        {t * x * x + c, t * x * y - s * z, t * x * z + s * y},
+        {t * x * y + s * z, t * y * y + c, t * y * z - s * x},
+        {t * x * z - s * y, t * y * z + s * x, t * z * z + c},
+    }};
+
+    return Transform(rotation, translation);
+}
+
+Vertex Transform::apply(const Vertex& vertex) const {
+    const Rotation& r = this->rotation;
+
+    return Vertex(
+        r[0][0] * vertex.x + r[0][1] * vertex.y + r[0][2] * vertex.z +
+            this->translation.x,
+        r[1][0] * vertex.x + r[1][1] * vertex.y + r[1][2] * vertex.z +
+            this->translation.y,
+        r[2][0] * vertex.x + r[2][1] * vertex.y + r[2][2] * vertex.z +
+            this->translation.z
+    );
+}
+
+Triangle Transform::apply(const Triangle& triangle) const {
+    return {
+        this->apply(triangle[0]),
+        this->apply(triangle[1]),
+        this->apply(triangle[2])
+    };
+}
+
+/**
+ * @brief Return the inverse transformation, using the transpose of the
+ * rotation.
+ *
+ * @return Transform inverse of this transformation
+ */
+Transform Transform::inverse() const {
+    Transform inverse;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            inverse.rotation[i][j] = this->rotation[j][i];
+
+    const Vertex moved = inverse.apply(this->translation);
+    inverse.translation = Vertex(-moved.x, -moved.y, -moved.z);
+
+    return inverse;
+}
+
+/**
+ * @brief Compose two transformations.
+ *
+ * @param other transformation applied first
+ * @return Transform transformation applying `other`, then this one
+ */
+Transform Transform::operator*(const Transform& other) const {
+    Transform product;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) {
+            product.rotation[i][j] = 0;
+            for (int k = 0; k < 3; k++)
+                product.rotation[i][j] +=
+                    this->rotation[i][k] * other.rotation[k][j];
+        }
+    product.translation = this->apply(other.translation);
+
+    return product;
+}
+
+/**
+ * @brief Check if two boxes overlap when the second one is moved by a rigid
+ * transformation.
+ *
+ * Separating axis test between the first box and the oriented box obtained
+ * by transforming the second one: the 3 face normals of each box and the 9
+ * cross products of their edges. The test is conservative: boxes that touch
+ * or nearly touch are reported as overlapping.
+ *
+ * @param box1 box in its own frame
+ * @param box2 box in the frame mapped to box1's frame by `transform`
+ * @param transform transformation from box2's frame to box1's frame
+ * @return true if the boxes may overlap
+ */
+bool YAAACD::helpers::boxes_overlap(
+    const BoundingBox& box1,
+    const BoundingBox& box2,
+    const Transform& transform
+) {
+    const Vertex center1 = box1.center();
+    const Vertex center2 = transform.apply(box2.center());
+
+    const std::array<double, 3> extent1 = {
+        (box1.upper().x - box1.lower().x) / 2,
+        (box1.upper().y - box1.lower().y) / 2,
+        (box1.upper().z - box1.lower().z) / 2
+    };
+    const std::array<double, 3> extent2 = {
+        (box2.upper().x - box2.lower().x) / 2,
+        (box2.upper().y - box2.lower().y) / 2,
+        (box2.upper().z - box2.lower().z) / 2
+    };
+    const std::array<double, 3> distance = {
+        center2.x - center1.x,
+        center2.y - center1.y,
+        center2.z - center1.z
+    };
+
+    const Rotation& r = transform.rotation;
+    Rotation absolute;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            absolute[i][j] = std::abs(r[i][j]) + SAT_EPSILON;
+
+    // Face normals of box1.
+    for (int i = 0; i < 3; i++) {
+        const double radius = extent2[0] * absolute[i][0] +
+                              extent2[1] * absolute[i][1] +
+                              extent2[2] * absolute[i][2];
+        if (std::abs(distance[i]) > extent1[i] + radius) return false;
+    }
+
+    // Face normals of box2.
+    for (int j = 0; j < 3; j++) {
+        const double radius = extent1[0] * absolute[0][j] +
+                              extent1[1] * absolute[1][j] +
+                              extent1[2] * absolute[2][j];
+        const double projected = distance[0] * r[0][j] +
+                                 distance[1] * r[1][j] +
+                                 distance[2] * r[2][j];
+        if (std::abs(projected) > extent2[j] + radius) return false;
+    }
+
+    // Cross products of the edge directions.
+    for (int i = 0; i < 3; i++) {
+        const int i1 = (i + 1) % 3;
+        const int i2 = (i + 2) % 3;
+
+        for (int j = 0; j < 3; j++) {
+            const int j1 = (j + 1) % 3;
+            const int j2 = (j + 2) % 3;
+
+            const double radius1 = extent1[i1] * absolute[i2][j] +
+                                   extent1[i2] * absolute[i1][j];
+            const double radius2 = extent2[j1] * absolute[i][j2] +
+                                   extent2[j2] * absolute[i][j1];
+            const double projected =
+                distance[i2] * r[i1][j] - distance[i1] * r[i2][j];
+            if (std::abs(projected) > radius1 + radius2) return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/mesh.hpp"
+
+// Scenes shared by the test files.
+namespace fixtures {
+
+/**
+ * @brief Random soup of small triangles, each with a corner drawn in
+ * [offset, offset + 10] x [0, 10] x [0, 10] and edges of at most 0.5 along
+ * each axis.
+ *
+ * @param count number of triangles
+ * @param offset shift of the soup along x
+ * @param seed seed of the generator, the same seed gives the same soup
+ * @return std::vector<YAAACD::Triangle> the triangles
+ */
+inline std::vector<YAAACD::Triangle> random_soup(
+    int count,
+    double offset,
+    unsigned seed
+) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coordinate(0, 10);
+    std::uniform_real_distribution<double> edge(-0.5, 0.5);
+
+    std::vector<YAAACD::Triangle> triangles;
+    for (int i = 0; i < count; i++) {
+        const YAAACD::Vertex a(
+            coordinate(generator) + offset,
+            coordinate(generator),
+            coordinate(generator)
+        );
+        const YAAACD::Vertex b(
+            a.x + edge(generator),
+            a.y + edge(generator),
+            a.z
+        );
+        const YAAACD::Vertex c(
+            a.x,
+            a.y + edge(generator),
+            a.z + edge(generator)
+        );
+        triangles.push_back({a, b, c});
+    }
+
+    return triangles;
+}
+
+/**
+ * @brief Welded grid of `nx` by `ny` quads, each split into two triangles
+ * facing up (+z).
+ *
+ * @param nx number of quads along x
+ * @param ny number of quads along y
+ * @param spacing side of a quad
+ * @param z height of the grid
+ * @param relief height added to vertex (i, j), flat if empty
+ * @return YAAACD::IndexedMesh the grid, over [0, nx * spacing] x
+ * [0, ny * spacing]
+ */
+inline YAAACD::IndexedMesh grid(
+    int nx,
+    int ny,
+    double spacing,
+    double z,
+    const std::function<double(int, int)>& relief = {}
+) {
+    YAAACD::IndexedMesh mesh;
+
+    for (int i = 0; i <= nx; i++)
+        for (int j = 0; j <= ny; j++)
+            mesh.vertices.emplace_back(
+                i * spacing,
+                j * spacing,
+                z + (relief ? relief(i, j) : 0)
+            );
+
+    const uint32_t row = ny + 1;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(nx); i++)
+        for (uint32_t j = 0; j < static_cast<uint32_t>(ny); j++) {
+            const uint32_t a = i * row + j;
+            const uint32_t b = a + row;
+            mesh.faces.push_back({a, b, b + 1});
+            mesh.faces.push_back({a, b + 1, a + 1});
+        }
+
+    return mesh;
+}
+
+}  // namespace fixtures
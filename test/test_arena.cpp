@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "../include/arena.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+TEST_CASE("Test arena alignment", "[arena]") {
+    Arena arena(256);
+
+    for (size_t alignment : {1, 8, 16, 64, 256}) {
+        void* pointer = arena.allocate(3, alignment);
+        REQUIRE(reinterpret_cast<uintptr_t>(pointer) % alignment == 0);
+    }
+}
+
+TEST_CASE("Test arena reset reuses its blocks", "[arena]") {
+    Arena arena(1024);
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 51; i++) pointers.push_back(arena.allocate(100, 8));
+    const size_t capacity = arena.capacity();
+    REQUIRE(capacity >= 5100);
+
+    for (void* pointer : pointers)
+        REQUIRE(reinterpret_cast<uintptr_t>(pointer) % 8 == 0);
+    REQUIRE(
+        std::set<void*>(pointers.begin(), pointers.end()).size() ==
+        pointers.size()
+    );
+
+    // The same requests land at the same addresses.
+    arena.reset();
+    for (void* pointer : pointers) REQUIRE(arena.allocate(100, 8) == pointer);
+    REQUIRE(arena.capacity() == capacity);
+}
+
+TEST_CASE("Test arena reset reuses blocks of any size", "[arena]") {
+    Arena arena(1024);
+
+    // Small requests, then one that needs a block of its own.
+    std::vector<void*> small;
+    for (int i = 0; i < 9; i++) small.push_back(arena.allocate(100, 8));
+    void* large = arena.allocate(2000, 8);
+    const size_t capacity = arena.capacity();
+
+    // In the other order, the large request takes the large block and the
+    // small ones the block it passed over.
+    arena.reset();
+    REQUIRE(arena.allocate(2000, 8) == large);
+    for (int i = 0; i < 9; i++) {
+        void* pointer = arena.allocate(100, 8);
+        REQUIRE(pointer == small[i]);
+    }
+    REQUIRE(arena.capacity() == capacity);
+}
+
+TEST_CASE("Test arena oversized allocation", "[arena]") {
+    Arena arena(64);
+
+    std::byte* pointer = static_cast<std::byte*>(arena.allocate(4096, 64));
+    pointer[0] = std::byte(1);
+    pointer[4095] = std::byte(2);
+    REQUIRE(arena.capacity() >= 4096);
+}
@@ -59,12 +59,12 @@ TEST_CASE("Test bounding box children", "[bounding_box]") {
     };
     BoundingBox box(vertices);
 
-    const std::array<BoundingBox*, 8>& children = box.children();
+    const std::array<BoundingBox, 8> children = box.children();
 
     for (int i = 0; i < 8; i++) {
-        REQUIRE(children[i]->level() == 1);
+        REQUIRE(children[i].level() == 1);
 
-        const std::array<Vertex, 8> corners = children[i]->corners();
+        const std::array<Vertex, 8> corners = children[i].corners();
         for (int j = 0; j < 8; j++) {
             int x = 0;
             int y = 0;
@@ -164,3 +164,39 @@ TEST_CASE("Test bounding box intersection", "[bounding_box]") {
 
     REQUIRE_FALSE(b1.intersects(b3));
 }
+
+TEST_CASE("Test bounding box cross intersection", "[bounding_box]") {
+    // No corner of either box lies inside the other one.
+    BoundingBox wide({Vertex(-10, -1, -1), Vertex(10, 1, 1)});
+    BoundingBox tall({Vertex(-1, -10, -1), Vertex(1, 10, 1)});
+
+    REQUIRE(wide.intersects(tall));
+    REQUIRE(tall.intersects(wide));
+}
+
+TEST_CASE("Test bounding box batched intersection", "[bounding_box]") {
+    std::vector<Vertex> vertices{Vertex(-10, -10, -10), Vertex(10, 10, 10)};
+    BoundingBox box(vertices);
+    const std::array<BoundingBox, 8> children = box.children();
+
+    BoundingBox probe({Vertex(1, 1, 1), Vertex(2, 2, 2)});
+    std::array<const BoundingBox*, 8> boxes;
+    for (int i = 0; i < 8; i++) boxes[i] = &children[i];
+
+    REQUIRE(probe.intersects(BoxPack(boxes)) == (1 << (RIGHT | TOP | FRONT)));
+
+    BoundingBox center({Vertex(-1, -1, -1), Vertex(1, 1, 1)});
+    REQUIRE(center.intersects(BoxPack(boxes)) == 0xff);
+
+    boxes[0] = nullptr;
+    REQUIRE(center.intersects(BoxPack(boxes)) == 0xfe);
+
+    for (int i = 0; i < 8; i++) {
+        uint8_t expected = 0;
+        for (int j = 0; j < 8; j++)
+            if (boxes[j] && children[i].intersects(*boxes[j]))
+                expected |= 1 << j;
+
+        REQUIRE(children[i].intersects(BoxPack(boxes)) == expected);
+    }
+}
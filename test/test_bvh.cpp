@@ -0,0 +1,117 @@
+#include <cmath>
+#include <vector>
+
+#include "../include/bvh.hpp"
+#include "../include/octree.hpp"
+#include "../include/policy.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+// Long, thin strip of triangles along x, tilted around it.
+static std::vector<Triangle> bvh_strip(int count, double offset, double tilt) {
+    std::vector<Triangle> triangles;
+
+    for (int i = 0; i < count; i++) {
+        const double x = i * 0.1;
+        Vertex a(x, offset, std::sin(x) / 50);
+        Vertex b(x + 0.1, offset, std::sin(x + 0.1) / 50);
+        Vertex c(x, offset + 0.05, std::sin(x) / 50 + tilt);
+        triangles.push_back({a, b, c});
+    }
+
+    return triangles;
+}
+
+TEST_CASE("Test bvh layout", "[bvh]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(3000, 0, 1);
+    Bvh bvh(triangles);
+    const auto& nodes = bvh.nodes();
+
+    REQUIRE_FALSE(nodes[0].is_leaf());
+
+    std::vector<int> parents(nodes.size(), 0);
+    std::vector<bool> covered(triangles.size(), false);
+    for (const Bvh::Node& node : nodes) {
+        if (node.is_leaf()) {
+            REQUIRE(node.count <= MAX_LEAF_SIZE);
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                REQUIRE_FALSE(covered[i]);
+                covered[i] = true;
+            }
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + 2; i++) {
+            REQUIRE(nodes[i].bounds.lower.x >= node.bounds.lower.x);
+            REQUIRE(nodes[i].bounds.upper.z <= node.bounds.upper.z);
+            parents[i]++;
+        }
+    }
+
+    REQUIRE(parents[0] == 0);
+    for (size_t i = 1; i < nodes.size(); i++) REQUIRE(parents[i] == 1);
+    for (bool index_covered : covered) REQUIRE(index_covered);
+}
+
+TEST_CASE("Test bvh sah cost", "[bvh]") {
+    std::vector<Triangle> triangles = bvh_strip(2000, 0, 0.01);
+    Bvh bvh(triangles);
+
+    REQUIRE(bvh.sah_cost() > 0);
+    REQUIRE(bvh.sah_cost() < triangles.size() / 10.0);
+    REQUIRE(Bvh({triangles[0]}).sah_cost() == SAH_INTERSECTION_COST);
+}
+
+TEST_CASE("Test bvh collision matches brute force", "[bvh]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(400, 0, 2);
+    Bvh bvh(triangles);
+
+    for (unsigned seed = 3; seed < 8; seed++) {
+        std::vector<Triangle> other =
+            fixtures::random_soup(400, 0.05 * seed, seed);
+        const bool expected = bruteforce_collides(triangles, other);
+
+        Octree octree(other);
+        REQUIRE(bvh.collides(Bvh(other)) == expected);
+        REQUIRE(bvh.collides(&octree) == expected);
+    }
+}
+
+TEST_CASE("Test bvh collision on thin parts", "[bvh]") {
+    std::vector<Triangle> triangles = bvh_strip(2000, 0, 0.01);
+    Bvh strip(triangles);
+
+    std::vector<Triangle> crossing = bvh_strip(2000, 0.02, 0.05);
+    std::vector<Triangle> apart = bvh_strip(2000, 0.2, 0.01);
+    REQUIRE(bruteforce_collides(triangles, crossing));
+
+    Octree crossing_octree(crossing);
+    Octree apart_octree(apart);
+
+    REQUIRE(strip.collides(Bvh(crossing)));
+    REQUIRE_FALSE(strip.collides(Bvh(apart)));
+    REQUIRE(strip.collides(&crossing_octree));
+    REQUIRE_FALSE(strip.collides(&apart_octree));
+}
+
+TEST_CASE("Test bvh collision with a loose octree", "[bvh]") {
+    // Walls spanning the soup stay with the root of the loose tree; the
+    // query only crosses a wall, below the soup.
+    std::vector<Triangle> triangles = fixtures::random_soup(3000, 0, 9);
+    for (int i = 0; i < 4; i++) {
+        const double x = 1 + 2.5 * i;
+        triangles.push_back(
+            {Vertex(x, -1, -1), Vertex(x, 11, -1), Vertex(x + 0.2, -1, 11)}
+        );
+    }
+    Octree loose(triangles, LooseOctreePolicy());
+    REQUIRE(loose.straddlers());
+
+    const std::vector<Triangle> query{
+        {Vertex(0.5, 5, -0.9), Vertex(1.5, 5, -0.9), Vertex(1, 5.3, -0.85)}
+    };
+    REQUIRE(bruteforce_collides(triangles, query));
+    REQUIRE(Bvh(query).collides(&loose));
+}
@@ -0,0 +1,265 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../include/ccd.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "../include/transform.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static std::vector<Triangle> ccd_cube(double size) {
+    std::vector<Vertex> vertices;
+    for (int i = 0; i < 8; i++)
+        vertices.emplace_back(
+            i & 4 ? size : 0,
+            i & 2 ? size : 0,
+            i & 1 ? size : 0
+        );
+
+    return {
+        {vertices[0], vertices[6], vertices[4]},
+        {vertices[0], vertices[2], vertices[6]},
+        {vertices[0], vertices[3], vertices[2]},
+        {vertices[0], vertices[1], vertices[3]},
+        {vertices[2], vertices[7], vertices[6]},
+        {vertices[2], vertices[3], vertices[7]},
+        {vertices[4], vertices[6], vertices[7]},
+        {vertices[4], vertices[7], vertices[5]},
+        {vertices[0], vertices[4], vertices[5]},
+        {vertices[0], vertices[5], vertices[1]},
+        {vertices[1], vertices[5], vertices[7]},
+        {vertices[1], vertices[7], vertices[3]},
+    };
+}
+
+// Thin wall in the plane x = 5, made of many small triangles.
+static std::vector<Triangle> ccd_wall(int size) {
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++) {
+            const double y = -4 + 8.0 * i / size, z = -4 + 8.0 * j / size;
+            const double step = 8.0 / size;
+            triangles.push_back(
+                {Vertex(5, y, z),
+                 Vertex(5, y + step, z),
+                 Vertex(5, y, z + step)}
+            );
+            triangles.push_back(
+                {Vertex(5, y + step, z),
+                 Vertex(5, y + step, z + step),
+                 Vertex(5, y, z + step)}
+            );
+        }
+
+    return triangles;
+}
+
+static double bruteforce_impact(
+    const IndexedMesh& mesh1,
+    const IndexedMesh& mesh2,
+    const Motion& motion1,
+    const Motion& motion2
+) {
+    const Transform start = motion1.start.inverse() * motion2.start;
+    const Transform end = motion1.end.inverse() * motion2.end;
+
+    double best = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < mesh1.size(); i++)
+        for (uint32_t j = 0; j < mesh2.size(); j++) {
+            const Triangle triangle2 = mesh2.triangle(j);
+            best = std::min(
+                best,
+                helpers::triangles_impact(
+                    mesh1.triangle(i),
+                    mesh1.triangle(i),
+                    start.apply(triangle2),
+                    end.apply(triangle2),
+                    best
+                )
+            );
+        }
+
+    return best;
+}
+
+TEST_CASE("Test triangle time of impact", "[ccd]") {
+    const Triangle floor = {Vertex(0, 0, 0), Vertex(4, 0, 0), Vertex(0, 4, 0)};
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    // A vertex falling onto the face.
+    const Triangle high = {Vertex(1, 1, 1), Vertex(2, 1, 3), Vertex(1, 2, 3)};
+    const Triangle low = {
+        Vertex(1, 1, -1),
+        Vertex(2, 1, 1),
+        Vertex(1, 2, 1)
+    };
+    REQUIRE(
+        std::abs(helpers::triangles_impact(floor, floor, high, low, inf) - 0.5)
+        < 1e-12
+    );
+    REQUIRE(helpers::triangles_impact(floor, floor, high, low, 0.4) == inf);
+    REQUIRE(helpers::triangles_impact(floor, floor, low, low, inf) == 0);
+    REQUIRE(helpers::triangles_impact(floor, floor, high, high, inf) == inf);
+
+    // The face moving up onto the vertex instead.
+    const Triangle raised = {
+        Vertex(0, 0, 2),
+        Vertex(4, 0, 2),
+        Vertex(0, 4, 2)
+    };
+    const double lifted =
+        helpers::triangles_impact(floor, raised, high, high, inf);
+    REQUIRE(std::abs(lifted - 0.5) < 1e-12);
+
+    // Two edges crossing, with no vertex ever reaching a face first.
+    const Triangle fin = {Vertex(0, -1, 0), Vertex(0, 1, 0), Vertex(0, 0, -1)};
+    const Triangle above = {
+        Vertex(-1, 0.5, 1),
+        Vertex(1, -0.5, 1),
+        Vertex(0, 0, 3)
+    };
+    const Triangle below = {
+        Vertex(-1, 0.5, -1),
+        Vertex(1, -0.5, -1),
+        Vertex(0, 0, 1)
+    };
+    REQUIRE(
+        std::abs(helpers::triangles_impact(fin, fin, above, below, inf) - 0.5)
+        < 1e-12
+    );
+
+    // Moving alongside without touching.
+    const Triangle beside = {
+        Vertex(-1, 3, 1),
+        Vertex(1, 3, 1),
+        Vertex(0, 3, 3)
+    };
+    const Triangle past = {
+        Vertex(-1, 3, -1),
+        Vertex(1, 3, -1),
+        Vertex(0, 3, 1)
+    };
+    REQUIRE(helpers::triangles_impact(fin, fin, beside, past, inf) == inf);
+}
+
+TEST_CASE("Test coplanar time of impact", "[ccd]") {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    const Triangle fixed = {Vertex(0, 0, 0), Vertex(1, 0, 0), Vertex(0, 1, 0)};
+
+    // Sliding right through the fixed triangle within its plane: apart at
+    // both ends of the step, the leading vertex reaches the hypotenuse
+    // x + y = 1 at x = 0.8.
+    const Triangle start = {
+        Vertex(3, 0.2, 0),
+        Vertex(4, 0.2, 0),
+        Vertex(3, 1.2, 0)
+    };
+    const Triangle end = {
+        Vertex(-4, 0.2, 0),
+        Vertex(-3, 0.2, 0),
+        Vertex(-4, 1.2, 0)
+    };
+    const double time =
+        helpers::triangles_impact(fixed, fixed, start, end, inf);
+    REQUIRE(std::abs(time - 2.2 / 7) < 1e-12);
+    REQUIRE(helpers::triangles_impact(fixed, fixed, start, end, 0.3) == inf);
+
+    // The same slide one unit further along y passes beside it.
+    const Triangle wide_start = {
+        Vertex(3, 1.2, 0),
+        Vertex(4, 1.2, 0),
+        Vertex(3, 2.2, 0)
+    };
+    const Triangle wide_end = {
+        Vertex(-4, 1.2, 0),
+        Vertex(-3, 1.2, 0),
+        Vertex(-4, 2.2, 0)
+    };
+    REQUIRE(
+        helpers::triangles_impact(fixed, fixed, wide_start, wide_end, inf) ==
+        inf
+    );
+}
+
+TEST_CASE("Test swept box overlap", "[ccd]") {
+    AABB fixed({Vertex(0, 0, 0), Vertex(1, 1, 1), Vertex(1, 1, 1)});
+    AABB start({Vertex(-3, 0, 0), Vertex(-2, 1, 1), Vertex(-2, 1, 1)});
+    AABB end({Vertex(2, 0, 0), Vertex(3, 1, 1), Vertex(3, 1, 1)});
+
+    double enter;
+    REQUIRE(helpers::sweep_overlap(fixed, start, end, 1, enter));
+    REQUIRE(std::abs(enter - 0.4) < 1e-12);
+    REQUIRE_FALSE(helpers::sweep_overlap(fixed, start, end, 0.3, enter));
+    REQUIRE_FALSE(helpers::sweep_overlap(fixed, start, start, 1, enter));
+    REQUIRE(helpers::sweep_overlap(fixed, fixed, fixed, 1, enter));
+    REQUIRE(enter == 0);
+}
+
+TEST_CASE("Test octree time of impact through a thin wall", "[ccd]") {
+    Octree wall(ccd_wall(16));
+    Octree cube(ccd_cube(1));
+
+    // The cube crosses the wall entirely within one step.
+    const Rotation identity = Transform().rotation;
+    const Motion still;
+    const Motion fast = {Transform(), Transform(identity, Vertex(10, 0, 0))};
+    REQUIRE_FALSE(wall.collides(&cube, fast.start));
+    REQUIRE_FALSE(wall.collides(&cube, fast.end));
+
+    const ImpactResult impact = wall.time_of_impact(&cube, still, fast);
+    REQUIRE(impact.found());
+    REQUIRE(std::abs(impact.time - 0.4) < 1e-12);
+
+    // The same motion seen from the cube.
+    const ImpactResult reverse = cube.time_of_impact(&wall, fast, still);
+    REQUIRE(reverse.found());
+    REQUIRE(std::abs(reverse.time - 0.4) < 1e-12);
+
+    // Stopping short of the wall.
+    const Motion slow = {Transform(), Transform(identity, Vertex(3, 0, 0))};
+    REQUIRE_FALSE(wall.time_of_impact(&cube, still, slow).found());
+}
+
+TEST_CASE("Test octree time of impact against brute force", "[ccd]") {
+    auto mesh1 = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(300, 0, 41)
+    );
+    auto mesh2 = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(300, 13, 42)
+    );
+    Octree tree1(mesh1);
+    Octree tree2(mesh2);
+
+    int found = 0;
+    for (int i = 0; i < 6; i++) {
+        const Motion motion1 = {
+            Transform::rotation_about(Vertex(0, 0, 1), 0.05 * i),
+            Transform::rotation_about(Vertex(1, 1, 0), 0.1, Vertex(1, 0, 0))
+        };
+        const Motion motion2 = {
+            Transform(),
+            Transform::rotation_about(
+                Vertex(0, 1, 0),
+                0.2,
+                Vertex(-2.0 * i, 0, 0)
+            )
+        };
+
+        const double expected =
+            bruteforce_impact(*mesh1, *mesh2, motion1, motion2);
+        const ImpactResult impact =
+            tree1.time_of_impact(&tree2, motion1, motion2);
+
+        REQUIRE(impact.found() == std::isfinite(expected));
+        if (!impact.found()) continue;
+
+        found++;
+        REQUIRE(impact.time == expected);
+    }
+    REQUIRE(found >= 3);
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../include/contacts.hpp"
+#include "../include/hashmap.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> PairList;
+
+static ContactCallback collect(PairList& pairs) {
+    return [&pairs](const Contact& contact) {
+        pairs.emplace_back(contact.first, contact.second);
+        return true;
+    };
+}
+
+TEST_CASE("Test contacts match brute force", "[contacts]") {
+    const IndexedMesh mesh1(fixtures::random_soup(1500, 0, 1));
+    const IndexedMesh mesh2(fixtures::random_soup(1500, 0.5, 2));
+
+    PairList expected;
+    bruteforce_contacts(mesh1, mesh2, collect(expected));
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(expected.size() > 10);
+
+    Octree tree1(std::make_shared<const IndexedMesh>(mesh1));
+    Octree tree2(std::make_shared<const IndexedMesh>(mesh2));
+    PairList octree_pairs;
+    REQUIRE(
+        tree1.contacts(&tree2, collect(octree_pairs)) == expected.size()
+    );
+    std::sort(octree_pairs.begin(), octree_pairs.end());
+    REQUIRE(octree_pairs == expected);
+
+    SpatialHashMap map(std::make_shared<const IndexedMesh>(mesh1), 4);
+    PairList map_pairs;
+    REQUIRE(map.contacts(mesh2, collect(map_pairs)) == expected.size());
+    std::sort(map_pairs.begin(), map_pairs.end());
+    REQUIRE(map_pairs == expected);
+}
+
+TEST_CASE("Test contacts limits", "[contacts]") {
+    Octree tree1(fixtures::random_soup(1500, 0, 3));
+    Octree tree2(fixtures::random_soup(1500, 0.5, 4));
+
+    PairList pairs;
+    REQUIRE(tree1.contacts(&tree2, collect(pairs), {5}) == 5);
+    REQUIRE(pairs.size() == 5);
+    REQUIRE(tree1.contacts(&tree2, collect(pairs), {0}) == 0);
+
+    size_t calls = 0;
+    const size_t reported = tree1.contacts(&tree2, [&calls](const Contact&) {
+        return ++calls < 3;
+    });
+    REQUIRE(reported == 3);
+    REQUIRE(calls == 3);
+
+    PairList all;
+    tree1.contacts(&tree2, collect(all));
+
+    std::vector<Contact> buffer(4);
+    REQUIRE(tree1.contacts(&tree2, buffer) == 4);
+    for (const Contact& contact : buffer) {
+        const auto pair = std::make_pair(contact.first, contact.second);
+        REQUIRE(std::find(all.begin(), all.end(), pair) != all.end());
+    }
+}
+
+TEST_CASE("Test contact segments", "[contacts]") {
+    const IndexedMesh horizontal(std::vector<Triangle>{
+        {Vertex(0, 0, 0), Vertex(4, 0, 0), Vertex(0, 4, 0)}
+    });
+    const IndexedMesh vertical(std::vector<Triangle>{
+        {Vertex(1, 1, -1), Vertex(1, 1, 1), Vertex(1, 3, 0)}
+    });
+
+    std::vector<Contact> contacts;
+    const size_t count = bruteforce_contacts(
+        horizontal,
+        vertical,
+        [&contacts](const Contact& contact) {
+            contacts.push_back(contact);
+            return true;
+        },
+        {1, true}
+    );
+    REQUIRE(count == 1);
+    REQUIRE(contacts[0].has_segment);
+
+    Vertex start = contacts[0].start;
+    Vertex end = contacts[0].end;
+    if (start.y > end.y) std::swap(start, end);
+    REQUIRE(std::abs(start.x - 1) < 1e-12);
+    REQUIRE(std::abs(start.y - 1) < 1e-12);
+    REQUIRE(std::abs(end.y - 3) < 1e-12);
+    REQUIRE(std::abs(start.z) + std::abs(end.z) < 1e-12);
+
+    // Coplanar overlaps have no segment.
+    Vertex ignored;
+    REQUIRE_FALSE(helpers::intersection_segment(
+        horizontal.triangle(0),
+        {Vertex(1, 1, 0), Vertex(2, 1, 0), Vertex(1, 2, 0)},
+        ignored,
+        ignored
+    ));
+}
+
+static double contact_wave(int i, int j) {
+    return std::sin(i + j) / 8;
+}
+
+// contact_wave tilted along x, crossing the flat wave along x = 20.
+static double contact_slope(int i, int j) {
+    return 0.3 * (i - 20) + contact_wave(i, j);
+}
+
+static PairList bruteforce_self_contacts(const IndexedMesh& mesh) {
+    PairList pairs;
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        for (uint32_t j = i + 1; j < mesh.size(); j++) {
+            const Face& a = mesh.faces[i];
+            const Face& b = mesh.faces[j];
+            if (std::find_first_of(a.begin(), a.end(), b.begin(), b.end()) !=
+                a.end())
+                continue;
+
+            if (helpers::triangles_intersect(
+                    mesh.triangle(i),
+                    mesh.triangle(j)
+                ))
+                pairs.emplace_back(i, j);
+        }
+
+    return pairs;
+}
+
+TEST_CASE("Test self contacts match brute force", "[contacts]") {
+    auto mesh =
+        std::make_shared<const IndexedMesh>(fixtures::random_soup(2500, 0, 5));
+    PairList expected = bruteforce_self_contacts(*mesh);
+    REQUIRE(expected.size() > 10);
+
+    Octree tree(mesh);
+    PairList pairs;
+    REQUIRE(tree.self_contacts(collect(pairs)) == expected.size());
+    std::sort(pairs.begin(), pairs.end());
+    REQUIRE(pairs == expected);
+    REQUIRE(tree.self_collides());
+
+    PairList limited;
+    REQUIRE(tree.self_contacts(collect(limited), {3}) == 3);
+}
+
+// Welded sheet of contact_wave with a second, disconnected sheet of
+// contact_slope crossing it, facing up as well or flipped to face down.
+static IndexedMesh crossing_sheets(bool flipped) {
+    IndexedMesh crossing = fixtures::grid(40, 40, 1, 0, contact_wave);
+    const IndexedMesh tilted = fixtures::grid(40, 40, 1, 0, contact_slope);
+    const uint32_t offset = crossing.vertices.size();
+    crossing.vertices.insert(
+        crossing.vertices.end(),
+        tilted.vertices.begin(),
+        tilted.vertices.end()
+    );
+    for (const Face& face : tilted.faces)
+        crossing.faces.push_back(
+            flipped ? Face{face[0] + offset, face[2] + offset, face[1] + offset}
+                    : Face{face[0] + offset, face[1] + offset, face[2] + offset}
+        );
+
+    return crossing;
+}
+
+TEST_CASE("Test self collision of welded grids", "[contacts]") {
+    // Neighbours share vertices, so the tree trivially collides with
+    // itself but the mesh does not intersect itself.
+    Octree cloth(
+        std::make_shared<const IndexedMesh>(
+            fixtures::grid(40, 40, 1, 0, contact_wave)
+        )
+    );
+    REQUIRE(cloth.collides(&cloth));
+    REQUIRE_FALSE(cloth.self_collides());
+
+    // Sheets facing the same way have normals within a narrow cone, yet
+    // cross each other as much as sheets facing opposite ways.
+    for (const bool flipped : {false, true}) {
+        auto mesh = std::make_shared<const IndexedMesh>(
+            crossing_sheets(flipped)
+        );
+        PairList expected = bruteforce_self_contacts(*mesh);
+        REQUIRE(expected.size() > 10);
+
+        Octree tree(mesh);
+        PairList pairs;
+        REQUIRE(tree.self_contacts(collect(pairs)) == expected.size());
+        std::sort(pairs.begin(), pairs.end());
+        REQUIRE(pairs == expected);
+        REQUIRE(tree.self_collides());
+    }
+}
+
+TEST_CASE("Test self collision follows refit", "[contacts]") {
+    auto mesh =
+        std::make_shared<const IndexedMesh>(fixtures::grid(20, 20, 1, 0));
+    Octree sheet(mesh);
+    REQUIRE_FALSE(sheet.self_collides());
+
+    // Fold the half past x = 10 back over the other one, tilted so that it
+    // crosses it along x = 5.
+    std::vector<Vertex> folded = mesh->vertices;
+    for (Vertex& vertex : folded)
+        if (vertex.x > 10)
+            vertex = Vertex(20 - vertex.x, vertex.y, 0.3 * (vertex.x - 15));
+
+    sheet.refit(folded);
+    const IndexedMesh moved(folded, mesh->faces);
+    REQUIRE_FALSE(bruteforce_self_contacts(moved).empty());
+    REQUIRE(sheet.self_collides());
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../include/distance.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static double bruteforce_distance(
+    const IndexedMesh& mesh1,
+    const IndexedMesh& mesh2
+) {
+    double best = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < mesh1.size(); i++)
+        for (uint32_t j = 0; j < mesh2.size(); j++) {
+            Vertex point1, point2;
+            best = std::min(
+                best,
+                helpers::triangle_distance_squared(
+                    mesh1.triangle(i),
+                    mesh2.triangle(j),
+                    point1,
+                    point2
+                )
+            );
+        }
+
+    return std::sqrt(best);
+}
+
+TEST_CASE("Test triangle distance", "[distance]") {
+    const Triangle floor = {Vertex(0, 0, 0), Vertex(4, 0, 0), Vertex(0, 4, 0)};
+    Vertex point1, point2;
+
+    // Vertex above the face.
+    const Triangle above = {Vertex(1, 1, 2), Vertex(2, 1, 3), Vertex(1, 2, 3)};
+    REQUIRE(
+        helpers::triangle_distance_squared(floor, above, point1, point2) == 4
+    );
+    REQUIRE(point1 == Vertex(1, 1, 0));
+    REQUIRE(point2 == Vertex(1, 1, 2));
+
+    // Edge against edge, crossing at right angles one unit apart.
+    const Triangle crossing = {
+        Vertex(3, -1, -1),
+        Vertex(3, 3, -1),
+        Vertex(3, 1, -5)
+    };
+    const Triangle beam = {Vertex(1, 1, 1), Vertex(5, 1, 1), Vertex(3, 1, 5)};
+    REQUIRE(
+        std::abs(
+            helpers::triangle_distance_squared(
+                crossing,
+                beam,
+                point1,
+                point2
+            ) -
+            4
+        ) < 1e-12
+    );
+
+    // Intersecting triangles.
+    const Triangle through = {
+        Vertex(1, 1, -1),
+        Vertex(1, 1, 1),
+        Vertex(1, 3, 0)
+    };
+    REQUIRE(
+        helpers::triangle_distance_squared(floor, through, point1, point2) == 0
+    );
+    REQUIRE(std::abs(point1.z) < 1e-12);
+}
+
+TEST_CASE("Test octree distance matches brute force", "[distance]") {
+    for (unsigned seed = 0; seed < 4; seed++) {
+        const IndexedMesh mesh1(fixtures::random_soup(400, 0, 2 * seed));
+        const IndexedMesh mesh2(
+            fixtures::random_soup(400, 10.5 + seed, 2 * seed + 1)
+        );
+        const double expected = bruteforce_distance(mesh1, mesh2);
+
+        Octree tree1(std::make_shared<const IndexedMesh>(mesh1));
+        Octree tree2(std::make_shared<const IndexedMesh>(mesh2));
+
+        const DistanceResult result = tree1.distance(&tree2);
+        REQUIRE(result.found());
+        REQUIRE(std::abs(result.distance - expected) < 1e-12);
+
+        Vertex point1, point2;
+        REQUIRE(
+            std::abs(
+                std::sqrt(helpers::triangle_distance_squared(
+                    mesh1.triangle(result.first),
+                    mesh2.triangle(result.second),
+                    point1,
+                    point2
+                )) -
+                expected
+            ) < 1e-12
+        );
+
+        REQUIRE_FALSE(tree1.distance(&tree2, expected * 0.99).found());
+        REQUIRE(tree1.distance(&tree2, expected * 1.01).found());
+        REQUIRE(tree1.closer_than(&tree2, expected * 1.01));
+        REQUIRE_FALSE(tree1.closer_than(&tree2, expected * 0.99));
+
+        // Negative bounds are not squared into positive ones.
+        REQUIRE_FALSE(tree1.distance(&tree2, -2 * expected).found());
+        REQUIRE_FALSE(tree1.closer_than(&tree2, -2 * expected));
+    }
+
+    Octree tree1(fixtures::random_soup(1000, 0, 10));
+    Octree tree2(fixtures::random_soup(1000, 0.5, 11));
+    REQUIRE(tree1.collides(&tree2));
+    REQUIRE(tree1.distance(&tree2).distance == 0);
+}
@@ -1,10 +1,14 @@
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "../include/hashmap.hpp"
 #include "../include/octree.hpp"
+#include "./fixtures.hpp"
 #include "catch2/catch_test_macros.hpp"
 
 constexpr int RIGHT = 0b100;
@@ -130,3 +134,166 @@ TEST_CASE("Test hashmap collision false", "[hashmap]") {
 
     REQUIRE_FALSE(map.collides(cube2));
 }
+
+TEST_CASE("Test cell table keys", "[hashmap]") {
+    CellTable table(4096);
+
+    uint32_t id = 0;
+    for (int32_t x = -8; x < 8; x++)
+        for (int32_t y = -8; y < 8; y++)
+            for (int32_t z = -8; z < 8; z++)
+                REQUIRE(table.insert({x, y, z}) == id++);
+
+    REQUIRE(table.size() == 4096);
+    REQUIRE(table.capacity() >= 2 * table.size());
+    REQUIRE(table.insert({-8, -8, -8}) == 0);
+    REQUIRE(table.find({7, 7, 7}) == 4095);
+    REQUIRE(table.find({8, 0, 0}) == EMPTY_CELL);
+}
+
+TEST_CASE("Test hashmap matches brute force", "[hashmap]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(1000, 0, 11);
+    SpatialHashMap map(triangles, 3);
+    SpatialHashMap coarse(triangles, 3, 4.0);
+    SpatialHashMap fine(triangles, 3, 0.1);
+
+    REQUIRE(map.cell_size() > 0);
+    REQUIRE(coarse.cell_size() == 4.0);
+    REQUIRE(coarse.cell_count() < map.cell_count());
+
+    for (unsigned seed = 12; seed < 22; seed++) {
+        std::vector<Triangle> other = fixtures::random_soup(30, 0, seed);
+        const bool expected = bruteforce_collides(triangles, other);
+
+        REQUIRE(map.collides(other) == expected);
+        REQUIRE(coarse.collides(other) == expected);
+        REQUIRE(fine.collides(other) == expected);
+    }
+}
+
+TEST_CASE("Test hashmap queries larger than the mesh", "[hashmap]") {
+    // Cells of 1/32: a 200 unit triangle spans millions of them, the stored
+    // triangle about a thousand.
+    const std::vector<Triangle> triangles{
+        {Vertex(0, 0, 0), Vertex(1, 0, 0), Vertex(0, 1, 0)}
+    };
+    const SpatialHashMap map(triangles, 5);
+
+    const std::vector<Triangle> far{
+        {Vertex(1000, 0, 0), Vertex(1200, 0, 0), Vertex(1000, 200, 200)}
+    };
+    REQUIRE_FALSE(map.collides(far));
+
+    // Boxes overlap the triangle, but only the first plane crosses it.
+    const std::vector<Triangle> crossing{
+        {Vertex(0.2, 0.2, -100), Vertex(0.2, 0.2, 100), Vertex(200, 200, 0)}
+    };
+    const std::vector<Triangle> below{
+        {Vertex(-100, -100, -1.5),
+         Vertex(100, -100, 0.5),
+         Vertex(-100, 100, -1.5)}
+    };
+    REQUIRE(bruteforce_collides(triangles, crossing));
+    REQUIRE_FALSE(bruteforce_collides(triangles, below));
+    REQUIRE(map.collides(crossing));
+    REQUIRE_FALSE(map.collides(below));
+}
+
+static double largest_extent(const std::vector<Triangle>& triangles) {
+    double largest = 0;
+    for (const Triangle& triangle : triangles) {
+        const AABB box(triangle);
+        largest = std::max(
+            {largest,
+             box.upper.x - box.lower.x,
+             box.upper.y - box.lower.y,
+             box.upper.z - box.lower.z}
+        );
+    }
+
+    return largest;
+}
+
+TEST_CASE("Test hashmap coarsens tiny cells", "[hashmap]") {
+    const std::vector<Triangle> triangles = fixtures::random_soup(100, 0, 41);
+    const SpatialHashMap map(triangles, 40);
+    REQUIRE(map.cell_size() == largest_extent(triangles) / 32);
+
+    // Would span the whole int32 range of cells at 40 levels.
+    const std::vector<Triangle> huge{
+        {Vertex(-1e12, 0, 0), Vertex(1e12, 0, 0), Vertex(0, 1e12, 0)}
+    };
+    REQUIRE(SpatialHashMap(huge, 40).cell_count() <= 33 * 33);
+
+    for (unsigned seed = 42; seed < 46; seed++) {
+        const std::vector<Triangle> other =
+            fixtures::random_soup(100, 0, seed);
+        REQUIRE(map.collides(other) == bruteforce_collides(triangles, other));
+    }
+
+    // Explicit sizes are kept.
+    const std::vector<Triangle> few = fixtures::random_soup(20, 0, 47);
+    REQUIRE(largest_extent(few) / 32 > 0.02);
+    const SpatialHashMap fine(few, 3, 0.02);
+    REQUIRE(fine.cell_size() == 0.02);
+    for (unsigned seed = 48; seed < 52; seed++) {
+        const std::vector<Triangle> other =
+            fixtures::random_soup(100, 0, seed);
+        REQUIRE(fine.collides(other) == bruteforce_collides(few, other));
+    }
+}
+
+TEST_CASE("Test hashmap table size", "[hashmap]") {
+    const std::vector<Triangle> triangles = fixtures::random_soup(500, 0, 53);
+    const SpatialHashMap sized(triangles, 3);
+    const SpatialHashMap small(triangles, 3, 0, 4);
+    REQUIRE(small.cell_count() == sized.cell_count());
+    REQUIRE(small.table_size() >= 2 * small.cell_count());
+    REQUIRE(small.table_size() < sized.table_size());
+
+    for (unsigned seed = 54; seed < 58; seed++) {
+        const std::vector<Triangle> other =
+            fixtures::random_soup(100, 0, seed);
+        REQUIRE(small.collides(other) == sized.collides(other));
+        REQUIRE(small.collides(other) == bruteforce_collides(triangles, other));
+    }
+}
+
+TEST_CASE("Test hashmap rejects too many cells", "[hashmap]") {
+    // At 5e-4, one triangle overlaps 2000^3 cells, more (cell, triangle)
+    // pairs than 32-bit offsets can count.
+    const std::vector<Triangle> triangles{
+        {Vertex(0, 0, 0), Vertex(1, 1, 0), Vertex(0, 1, 1)}
+    };
+    REQUIRE_THROWS_AS(SpatialHashMap(triangles, 3, 5e-4), std::length_error);
+    REQUIRE_NOTHROW(SpatialHashMap(triangles, 3, 1e-2));
+}
+
+TEST_CASE("Test hashmap cells past the int32 range", "[hashmap]") {
+    // With 1e-3 cells, coordinates of 1e9 are 1e12 cells away: every
+    // triangle falls in the corner cell of its octant.
+    const double far = 1e9;
+    const std::vector<Triangle> triangles{
+        {Vertex(far, far, far),
+         Vertex(far + 1, far, far),
+         Vertex(far, far + 1, far)},
+        {Vertex(-far, -far, -far),
+         Vertex(-far + 1, -far, -far),
+         Vertex(-far, -far + 1, -far)},
+    };
+    const SpatialHashMap map(triangles, 3, 1e-3);
+    REQUIRE(map.cell_count() == 2);
+
+    const std::vector<Triangle> crossing{
+        {Vertex(far + 0.2, far + 0.2, far - 1),
+         Vertex(far + 0.2, far + 0.2, far + 1),
+         Vertex(far + 0.3, far + 0.3, far + 1)},
+    };
+    const std::vector<Triangle> parallel{
+        {Vertex(-far, -far, 0.5 - far),
+         Vertex(-far + 1, -far, 0.5 - far),
+         Vertex(-far, -far + 1, 0.5 - far)},
+    };
+    REQUIRE(map.collides(crossing));
+    REQUIRE_FALSE(map.collides(parallel));
+}
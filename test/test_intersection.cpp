@@ -0,0 +1,71 @@
+#include "../include/common.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+TEST_CASE("Test crossing triangles", "[intersection]") {
+    Triangle triangle1{Vertex(0, 0, 0), Vertex(2, 0, 0), Vertex(0, 2, 0)};
+    Triangle triangle2{
+        Vertex(0.5, 0.5, -1),
+        Vertex(0.5, 0.5, 1),
+        Vertex(3, 3, 0)
+    };
+
+    REQUIRE(helpers::triangles_intersect(triangle1, triangle2));
+    REQUIRE(helpers::triangles_intersect(triangle2, triangle1));
+}
+
+TEST_CASE("Test separated triangles", "[intersection]") {
+    Triangle triangle1{Vertex(0, 0, 0), Vertex(2, 0, 0), Vertex(0, 2, 0)};
+    Triangle above{Vertex(0, 0, 1), Vertex(2, 0, 1), Vertex(0, 2, 2)};
+    Triangle beside{Vertex(2, 2, -1), Vertex(2, 2, 1), Vertex(3, 3, 0)};
+
+    REQUIRE_FALSE(helpers::triangles_intersect(triangle1, above));
+    REQUIRE_FALSE(helpers::triangles_intersect(triangle1, beside));
+}
+
+TEST_CASE("Test touching triangles", "[intersection]") {
+    Triangle triangle1{Vertex(0, 0, 0), Vertex(2, 0, 0), Vertex(0, 2, 0)};
+    Triangle shared_vertex{Vertex(2, 0, 0), Vertex(3, 0, 1), Vertex(3, 1, 0)};
+    Triangle shared_edge{Vertex(0, 0, 0), Vertex(2, 0, 0), Vertex(1, 0, 5)};
+    Triangle vertex_on_face{
+        Vertex(0.5, 0.5, 0),
+        Vertex(0.5, 0.5, 1),
+        Vertex(1, 0.5, 1)
+    };
+
+    REQUIRE(helpers::triangles_intersect(triangle1, shared_vertex));
+    REQUIRE(helpers::triangles_intersect(triangle1, shared_edge));
+    REQUIRE(helpers::triangles_intersect(triangle1, vertex_on_face));
+}
+
+TEST_CASE("Test coplanar triangles", "[intersection]") {
+    Triangle triangle1{Vertex(0, 0, 0), Vertex(2, 0, 0), Vertex(0, 2, 0)};
+    Triangle overlapping{Vertex(1, 1, 0), Vertex(3, 1, 0), Vertex(1, 3, 0)};
+    Triangle touching{Vertex(1, 1, 0), Vertex(3, 3, 0), Vertex(3, 0, 0)};
+    Triangle disjoint{Vertex(2, 2, 0), Vertex(4, 2, 0), Vertex(2, 4, 0)};
+    Triangle inside{
+        Vertex(0.2, 0.2, 0),
+        Vertex(0.4, 0.2, 0),
+        Vertex(0.2, 0.4, 0)
+    };
+
+    REQUIRE(helpers::triangles_intersect(triangle1, overlapping));
+    REQUIRE(helpers::triangles_intersect(triangle1, touching));
+    REQUIRE_FALSE(helpers::triangles_intersect(triangle1, disjoint));
+    REQUIRE(helpers::triangles_intersect(triangle1, inside));
+    REQUIRE(helpers::triangles_intersect(inside, triangle1));
+}
+
+TEST_CASE("Test orientation predicate", "[intersection]") {
+    Vertex a(0, 0, 0), b(1, 0, 0), c(0, 1, 0);
+
+    REQUIRE(helpers::orientation(a, b, c, Vertex(0, 0, 1)) == 1);
+    REQUIRE(helpers::orientation(a, b, c, Vertex(0, 0, -1)) == -1);
+    REQUIRE(helpers::orientation(a, b, c, Vertex(5, 7, 0)) == 0);
+
+    // Nearly degenerate: the floating-point filter must defer to the exact
+    // predicate instead of guessing a sign.
+    Vertex d(0.1 + 0.2, 0.3, 0);
+    REQUIRE(helpers::orientation(a, b, c, d) == 0);
+}
@@ -0,0 +1,113 @@
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../include/linear_octree.hpp"
+#include "../include/octree.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static std::vector<Triangle> linear_octree_cube(double offset) {
+    std::vector<Vertex> vertices{
+        Vertex(0, 0, 0),
+        Vertex(0, 0, 1),
+        Vertex(0, 1, 0),
+        Vertex(0, 1, 1),
+        Vertex(1, 0, 0),
+        Vertex(1, 0, 1),
+        Vertex(1, 1, 0),
+        Vertex(1, 1, 1),
+    };
+
+    for (Vertex& vertex : vertices)
+        vertex = Vertex(vertex.x + offset, vertex.y + offset, vertex.z + offset);
+
+    return {
+        {vertices[0], vertices[6], vertices[4]},
+        {vertices[0], vertices[2], vertices[6]},
+        {vertices[0], vertices[3], vertices[2]},
+        {vertices[0], vertices[1], vertices[3]},
+        {vertices[2], vertices[7], vertices[6]},
+        {vertices[2], vertices[3], vertices[7]},
+        {vertices[4], vertices[6], vertices[7]},
+        {vertices[4], vertices[7], vertices[5]},
+        {vertices[0], vertices[4], vertices[5]},
+        {vertices[0], vertices[5], vertices[1]},
+        {vertices[1], vertices[5], vertices[7]},
+        {vertices[1], vertices[7], vertices[3]},
+    };
+}
+
+static double linear_octree_wave(int i, int j) {
+    return std::sin(i + j) / 4;
+}
+
+TEST_CASE("Test linear octree collision", "[linear_octree]") {
+    LinearOctree tree1(linear_octree_cube(0));
+    LinearOctree tree2(linear_octree_cube(0.5));
+
+    REQUIRE(tree1.collides(tree2));
+}
+
+TEST_CASE("Test linear octree not colliding", "[linear_octree]") {
+    LinearOctree tree1(linear_octree_cube(0));
+    LinearOctree tree2(linear_octree_cube(5));
+
+    REQUIRE_FALSE(tree1.collides(tree2));
+}
+
+TEST_CASE("Test linear octree layout", "[linear_octree]") {
+    LinearOctree tree(
+        fixtures::grid(32, 32, 1, 0, linear_octree_wave).triangles()
+    );
+    const auto& nodes = tree.nodes();
+
+    REQUIRE_FALSE(nodes[0].is_leaf());
+
+    std::vector<int> parents(nodes.size(), 0);
+    std::vector<bool> covered(tree.indices().size(), false);
+    for (const LinearOctree::Node& node : nodes) {
+        if (node.is_leaf()) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                REQUIRE_FALSE(covered[i]);
+                covered[i] = true;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < std::popcount(node.children); i++) {
+            const LinearOctree::Node& child = nodes[node.first + i];
+            REQUIRE(child.lower.x >= node.lower.x);
+            REQUIRE(child.upper.x <= node.upper.x);
+            parents[node.first + i]++;
+        }
+    }
+
+    REQUIRE(parents[0] == 0);
+    for (size_t i = 1; i < nodes.size(); i++) REQUIRE(parents[i] == 1);
+    for (bool index_covered : covered) REQUIRE(index_covered);
+}
+
+TEST_CASE("Test linear octree matches octree", "[linear_octree]") {
+    std::vector<Triangle> grid =
+        fixtures::grid(24, 24, 1, 0, linear_octree_wave).triangles();
+
+    for (double height : {-1.0, 0.1, 2.0}) {
+        std::vector<Triangle> other =
+            fixtures::grid(24, 24, 1, height, linear_octree_wave).triangles();
+        for (Triangle& triangle : other)
+            for (Vertex& vertex : triangle)
+                vertex = Vertex(vertex.x + 0.3, vertex.y + 0.3, vertex.z);
+
+        Octree tree1(grid);
+        Octree tree2(other);
+
+        REQUIRE(
+            LinearOctree(grid).collides(LinearOctree(other)) ==
+            tree1.collides(&tree2)
+        );
+    }
+}
@@ -0,0 +1,68 @@
+#include <memory>
+#include <vector>
+
+#include "../include/bvh.hpp"
+#include "../include/hashmap.hpp"
+#include "../include/linear_octree.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static double mesh_ridge(int i, int j) {
+    return (i + j) % 2 * 0.1;
+}
+
+TEST_CASE("Test indexed mesh from triangles", "[mesh]") {
+    IndexedMesh grid = fixtures::grid(8, 8, 1, 0, mesh_ridge);
+    IndexedMesh mesh(grid.triangles());
+
+    REQUIRE(mesh.size() == grid.size());
+    REQUIRE(mesh.vertices.size() == grid.vertices.size());
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        REQUIRE(mesh.triangle(i) == grid.triangle(i));
+
+    IndexedMesh signed_zero(
+        std::vector<Triangle>{{Vertex(0, 0, 0), Vertex(1, 0, 0), Vertex(-0.0)}}
+    );
+    REQUIRE(signed_zero.vertices.size() == 2);
+}
+
+TEST_CASE("Test indexed mesh bounds", "[mesh]") {
+    IndexedMesh mesh = fixtures::grid(4, 4, 1, 1, mesh_ridge);
+    REQUIRE(mesh.bounds.empty());
+
+    mesh.compute_bounds();
+    REQUIRE(mesh.bounds.size() == mesh.size());
+    REQUIRE(mesh.bounds[0].lower.x == 0);
+    REQUIRE(mesh.bounds[0].upper.y == 1);
+    REQUIRE(mesh.bounds[0].upper.z == 1.1);
+}
+
+TEST_CASE("Test engines share an indexed mesh", "[mesh]") {
+    auto mesh =
+        std::make_shared<IndexedMesh>(fixtures::grid(40, 40, 1, 0, mesh_ridge));
+    mesh->compute_bounds();
+
+    Octree octree(mesh);
+    Bvh bvh(mesh);
+    LinearOctree linear(mesh);
+    SpatialHashMap map(mesh, 4);
+
+    for (double height : {-0.5, 0.05, 1.0}) {
+        IndexedMesh other = fixtures::grid(10, 10, 1, height, mesh_ridge);
+        for (Vertex& vertex : other.vertices)
+            vertex = Vertex(vertex.x + 0.3, vertex.y + 0.6, vertex.z);
+
+        const bool expected = bruteforce_collides(*mesh, other);
+        auto shared = std::make_shared<IndexedMesh>(other);
+        Octree other_octree(shared);
+
+        REQUIRE(octree.collides(&other_octree) == expected);
+        REQUIRE(bvh.collides(Bvh(shared)) == expected);
+        REQUIRE(linear.collides(LinearOctree(shared)) == expected);
+        REQUIRE(map.collides(other) == expected);
+    }
+}
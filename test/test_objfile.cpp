@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../include/objfile.hpp"
+#include "../include/scheduler.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+const std::string OBJ_TEXT =
+    "# comment with v 9 9 9\n"
+    "o cube v 1 2 3\n"
+    "v 0 0 0\n"
+    "v 1.5 0 0\n"
+    "  v\t0 +1 0\r\n"
+    "vn 0 0 1\n"
+    "vt 0.5 v 0.5\n"
+    "v 1 1 -2e-1 1.0\n"
+    "f 1 2 3\n"
+    "f 1/1 2/2/1 3//1 4\n"
+    "v 2 2 2\n"
+    "f -5 -4 -1\n";
+
+TEST_CASE("Test obj parsing", "[objfile]") {
+    IndexedMesh mesh = parse_obj(OBJ_TEXT.data(), OBJ_TEXT.size());
+
+    REQUIRE(mesh.vertices.size() == 5);
+    REQUIRE(mesh.vertices[1] == Vertex(1.5, 0, 0));
+    REQUIRE(mesh.vertices[2] == Vertex(0, 1, 0));
+    REQUIRE(mesh.vertices[3] == Vertex(1, 1, -0.2));
+
+    const std::vector<Face> faces = {
+        {0, 1, 2},
+        {0, 1, 2},
+        {0, 2, 3},
+        {0, 1, 4},
+    };
+    REQUIRE(mesh.faces == faces);
+    REQUIRE(mesh.triangles()[3][2] == Vertex(2, 2, 2));
+}
+
+TEST_CASE("Test obj parsing in parallel chunks", "[objfile]") {
+    std::string text;
+    for (int i = 0; i < 500; i++) {
+        text += "v " + std::to_string(i) + " 0 0\n";
+        text += "v " + std::to_string(i) + " 1 0\n";
+        if (i > 0) text += "f -1 -2 -4 -3\n";
+    }
+
+    TaskPool pool(4);
+    IndexedMesh sequential = parse_obj(text.data(), text.size());
+    IndexedMesh parallel = parse_obj(text.data(), text.size(), &pool, 64);
+
+    REQUIRE(sequential.vertices.size() == 1000);
+    REQUIRE(sequential.faces.size() == 2 * 499);
+    REQUIRE(parallel.vertices == sequential.vertices);
+    REQUIRE(parallel.faces == sequential.faces);
+    REQUIRE(parallel.faces.back()[0] == 999);
+}
+
+TEST_CASE("Test obj file loading", "[objfile]") {
+    const std::string filename = "test_objfile.obj";
+    std::ofstream(filename) << OBJ_TEXT;
+
+    std::vector<Triangle> triangles = parse_obj_file(filename);
+    std::remove(filename.c_str());
+
+    REQUIRE(triangles.size() == 4);
+    REQUIRE(triangles[0][1] == Vertex(1.5, 0, 0));
+    REQUIRE_THROWS_AS(load_obj("missing.obj"), std::system_error);
+}
+
+TEST_CASE("Test malformed obj data", "[objfile]") {
+    const std::string out_of_range = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+    const std::string bad_vertex = "v 0 zero 0\n";
+
+    REQUIRE_THROWS_AS(
+        parse_obj(out_of_range.data(), out_of_range.size()),
+        std::runtime_error
+    );
+    REQUIRE_THROWS_AS(
+        parse_obj(bad_vertex.data(), bad_vertex.size()),
+        std::runtime_error
+    );
+}
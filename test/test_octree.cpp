@@ -1,10 +1,17 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 #include "../include/common.hpp"
 #include "../include/hashmap.hpp"
 #include "../include/objfile.hpp"
 #include "../include/octree.hpp"
+#include "./fixtures.hpp"
 #include "catch2/catch_test_macros.hpp"
 
 constexpr int RIGHT = 0b100;
@@ -136,3 +143,666 @@ TEST_CASE("Test octree not colliding", "[octree]") {
 
     REQUIRE_FALSE(collides);
 }
+
+static void count_leaf_members(OctreeNode* node, size_t& members) {
+    if (!node->has_children()) {
+        members += node->size();
+        return;
+    }
+
+    size_t children = 0;
+    for (OctreeNode* child : node->children())
+        if (child) {
+            REQUIRE(child->level() == node->level() + 1);
+            children += child->size();
+            count_leaf_members(child, members);
+        }
+    REQUIRE(children == node->size());
+}
+
+TEST_CASE("Test octree build keeps every triangle", "[octree]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(5000, 0, 1);
+    Octree tree(triangles);
+
+    const BuildStats& stats = tree.build();
+    REQUIRE(stats.triangles == triangles.size());
+    REQUIRE(stats.leaves > 1);
+    REQUIRE(stats.nodes > stats.leaves);
+
+    size_t members = 0;
+    count_leaf_members(&tree, members);
+    REQUIRE(members == triangles.size());
+}
+
+TEST_CASE("Test octree collision matches brute force", "[octree]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(400, 0, 2);
+    TaskPool pool(2);
+
+    for (unsigned seed = 3; seed < 8; seed++) {
+        std::vector<Triangle> other =
+            fixtures::random_soup(400, 0.05 * seed, seed);
+        const bool expected = bruteforce_collides(triangles, other);
+
+        Octree tree1(triangles);
+        Octree tree2(other);
+        REQUIRE(tree1.collides(&tree2) == expected);
+
+        Octree parallel1(triangles);
+        Octree parallel2(other);
+        parallel1.build(&pool);
+        REQUIRE(parallel1.collides(&parallel2, pool) == expected);
+    }
+}
+
+// Never splits: the whole mesh in the root.
+struct FlatPolicy : DefaultOctreePolicy {
+    static constexpr int depth_limit = 0;
+    static constexpr uint32_t leaf_size = 1;
+};
+
+// Small leaves, well below the default depth limit.
+struct DeepPolicy : DefaultOctreePolicy {
+    static constexpr int depth_limit = 9;
+    static constexpr uint32_t leaf_size = 4;
+    static constexpr double min_share = 0;
+};
+
+struct TooDeepPolicy : DefaultOctreePolicy {
+    static constexpr int depth_limit = MAX_DEPTH_LIMIT + 1;
+};
+
+struct TightLoosePolicy : DefaultOctreePolicy {
+    static constexpr double looseness = 0.5;
+};
+
+struct IncompletePolicy {
+    static constexpr int depth_limit = 3;
+};
+
+static_assert(OctreePolicy<DefaultOctreePolicy>);
+static_assert(OctreePolicy<LooseOctreePolicy>);
+static_assert(OctreePolicy<DeepPolicy>);
+static_assert(!OctreePolicy<TooDeepPolicy>);
+static_assert(!OctreePolicy<TightLoosePolicy>);
+static_assert(!OctreePolicy<IncompletePolicy>);
+
+static int octree_depth(OctreeNode* node) {
+    int depth = node->level();
+    for (OctreeNode* child : node->children())
+        if (child) depth = std::max(depth, octree_depth(child));
+
+    return depth;
+}
+
+// Wavy sheet over [0, 10]^2, much denser than a soup of as many triangles.
+static std::vector<Triangle> octree_sheet(int side) {
+    const double spacing = 10.0 / side;
+    auto wave = [spacing](int i, int j) {
+        return 0.5 * std::sin(i * spacing) * std::cos(j * spacing);
+    };
+
+    return fixtures::grid(side, side, spacing, 5, wave).triangles();
+}
+
+TEST_CASE("Test octree policies", "[octree]") {
+    std::vector<Triangle> triangles = octree_sheet(60);
+    std::vector<Triangle> other = fixtures::random_soup(500, 0, 21);
+    const bool expected = bruteforce_collides(triangles, other);
+
+    Octree flat(triangles, FlatPolicy());
+    REQUIRE(flat.build().nodes == 1);
+    REQUIRE_FALSE(flat.has_children());
+
+    Octree regular(triangles);
+    Octree deep(triangles, DeepPolicy());
+    TaskPool pool(2);
+    REQUIRE(deep.build(&pool).nodes > regular.build().nodes);
+    REQUIRE(octree_depth(&regular) <= DEPTH_LIMIT);
+    REQUIRE(octree_depth(&deep) > DEPTH_LIMIT);
+    REQUIRE(octree_depth(&deep) <= DeepPolicy::depth_limit);
+
+    size_t members = 0;
+    count_leaf_members(&deep, members);
+    REQUIRE(members == triangles.size());
+
+    Octree query(other, DeepPolicy());
+    REQUIRE(deep.collides(&query) == expected);
+    REQUIRE(flat.collides(&query) == expected);
+
+    const Ray ray = {Vertex(3.3, 4.1, 0), Vertex(0.01, 0.02, 1)};
+    const RayHit hit = regular.raycast(ray);
+    REQUIRE(hit.found());
+    REQUIRE(deep.raycast(ray).distance == hit.distance);
+
+    // Subtrees rebuilt by a refit follow the policy of the tree.
+    auto mesh = std::make_shared<const IndexedMesh>(triangles);
+    Octree refitted(mesh, DeepPolicy());
+    refitted.build();
+    std::vector<Vertex> positions = mesh->vertices;
+    for (Vertex& vertex : positions) vertex.x *= 3;
+
+    const RefitStats stats = refitted.refit(positions);
+    REQUIRE(stats.rebuilt_triangles > 0);
+    REQUIRE(octree_depth(&refitted) > DEPTH_LIMIT);
+}
+
+// Only the root owns the arena, so only the root can be reset.
+template <typename Node>
+constexpr bool resettable = requires(Node& node) { node.reset(nullptr); };
+
+TEST_CASE("Test octree reset reuses its arena", "[octree]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(3000, 0, 11);
+    std::vector<Triangle> other = fixtures::random_soup(3000, 0.5, 12);
+
+    Octree tree(triangles);
+    const size_t nodes = tree.build().nodes;
+    const size_t capacity = tree.arena_capacity();
+    REQUIRE(capacity > 0);
+
+    tree.reset(std::make_shared<const IndexedMesh>(other));
+    REQUIRE(tree.size() == other.size());
+    tree.build();
+    tree.reset(std::make_shared<const IndexedMesh>(triangles));
+    REQUIRE(tree.build().nodes == nodes);
+    REQUIRE(tree.arena_capacity() == capacity);
+
+    size_t members = 0;
+    count_leaf_members(&tree, members);
+    REQUIRE(members == triangles.size());
+
+    static_assert(resettable<Octree>);
+    static_assert(!resettable<OctreeNode>);
+}
+
+TEST_CASE("Test octree move", "[octree]") {
+    std::vector<Triangle> triangles = fixtures::random_soup(1000, 0, 13);
+    std::vector<Triangle> other = fixtures::random_soup(1000, 0.05, 14);
+    const bool expected = bruteforce_collides(triangles, other);
+
+    Octree tree(triangles);
+    tree.build();
+    Octree moved(std::move(tree));
+
+    Octree target(other);
+    target.build();
+    Octree query(other);
+    target = std::move(query);
+
+    REQUIRE(moved.size() == triangles.size());
+    REQUIRE(moved.collides(&target) == expected);
+}
+
+static size_t count_nodes(OctreeNode* node) {
+    size_t nodes = 1;
+    for (OctreeNode* child : node->children())
+        if (child) nodes += count_nodes(child);
+
+    return nodes;
+}
+
+TEST_CASE("Test loose partition keeps straddlers", "[octree]") {
+    const std::vector<Triangle> triangles = {
+        {Vertex(0.1, 0.1, 0.1), Vertex(0.5, 0.1, 0.1), Vertex(0.1, 0.5, 0.1)},
+        {Vertex(3.5, 3.5, 3.5), Vertex(3.9, 3.5, 3.5), Vertex(3.5, 3.9, 3.5)},
+        // Spans the whole cell.
+        {Vertex(0, 0, 0), Vertex(4, 0, 0), Vertex(0, 4, 4)},
+        // Crosses the center plane, but only by a quarter of an octant.
+        {Vertex(1.6, 0.2, 0.2), Vertex(2.6, 0.2, 0.2), Vertex(1.6, 0.6, 0.2)},
+    };
+    const std::vector<AABB> boxes = triangle_bounds(triangles);
+    AABB cell;
+    cell.lower = Vertex(0, 0, 0);
+    cell.upper = Vertex(4, 4, 4);
+
+    std::vector<uint32_t> indices = {0, 1, 2, 3};
+    OctantSplit split =
+        helpers::partition_loose(indices.data(), 4, boxes, cell, 2);
+    REQUIRE(split.straddlers == 1);
+    REQUIRE(indices[0] == 2);
+    REQUIRE(split.straddler_bounds.upper == Vertex(4, 4, 4));
+    REQUIRE(split.offsets[0] == 1);
+    REQUIRE(split.offsets[8] == 4);
+    REQUIRE(split.count(0) == 1);
+    REQUIRE(split.count(RIGHT) == 1);
+    REQUIRE(split.count(RIGHT | TOP | FRONT) == 1);
+
+    // Without looseness, octants only keep the members they contain.
+    split = helpers::partition_loose(indices.data(), 4, boxes, cell, 1);
+    REQUIRE(split.straddlers == 2);
+    REQUIRE(split.count(RIGHT) == 0);
+}
+
+// Small triangles and a few walls spanning the whole scene, as in
+// architectural meshes.
+static std::vector<Triangle> octree_walls(int count, unsigned seed) {
+    std::vector<Triangle> triangles = fixtures::random_soup(count, 0, seed);
+    for (int i = 0; i < 4; i++) {
+        const double x = 1 + 2.5 * i;
+        triangles.push_back(
+            {Vertex(x, -1, -1), Vertex(x, 11, -1), Vertex(x + 0.2, -1, 11)}
+        );
+    }
+
+    return triangles;
+}
+
+// Members stored in the node itself rather than in its children: all of a
+// leaf's, the straddlers of an inner node of a loose tree. They come first
+// in the node's range and are the ones it packs.
+static size_t own_members(OctreeNode* node) {
+    size_t children = 0;
+    for (OctreeNode* child : node->children())
+        if (child) children += child->size();
+    REQUIRE(children <= node->size());
+
+    const size_t own = node->size() - children;
+    size_t packed = 0;
+    for (const TrianglePack& pack : node->packs()) {
+        for (uint32_t lane = 0; lane < pack.size; lane++)
+            REQUIRE(pack.ids[lane] == node->members()[packed + lane]);
+        packed += pack.size;
+    }
+    REQUIRE(packed == own);
+
+    return own;
+}
+
+// Every member is stored once, either in a leaf or as a straddler of an
+// inner node, and children follow the straddlers in their parent's range.
+static void loose_leaf_members(OctreeNode* node, size_t& members) {
+    const size_t own = own_members(node);
+    members += own;
+
+    const uint32_t* next = node->members().data() + own;
+    for (OctreeNode* child : node->children())
+        if (child) {
+            REQUIRE(child->level() == node->level() + 1);
+            REQUIRE(child->members().data() == next);
+            next += child->size();
+            loose_leaf_members(child, members);
+        }
+}
+
+static AABB node_box(const BoundingBox& bounds) {
+    AABB box;
+    box.lower = bounds.lower();
+    box.upper = bounds.upper();
+
+    return box;
+}
+
+// Octant of a cell, grown by `looseness` around its center.
+static AABB loose_octant(const AABB& cell, int octant, double looseness) {
+    AABB box = helpers::octant_cell(cell, octant);
+    const double grow = (looseness - 1) / 4;
+
+    for (double Vertex::*axis : {&Vertex::x, &Vertex::y, &Vertex::z}) {
+        const double margin = grow * (cell.upper.*axis - cell.lower.*axis);
+        box.lower.*axis -= margin;
+        box.upper.*axis += margin;
+    }
+
+    return box;
+}
+
+static bool box_contains(const AABB& outer, const AABB& inner) {
+    for (double Vertex::*axis : {&Vertex::x, &Vertex::y, &Vertex::z})
+        if (inner.lower.*axis < outer.lower.*axis ||
+            inner.upper.*axis > outer.upper.*axis)
+            return false;
+
+    return true;
+}
+
+// Check if a box lies in an octant of a cell, grown by `looseness`.
+static bool in_loose_octant(
+    const BoundingBox& bounds,
+    const AABB& cell,
+    int octant,
+    double looseness
+) {
+    return box_contains(
+        loose_octant(cell, octant, looseness),
+        node_box(bounds)
+    );
+}
+
+// Octant of a cell holding the center of a box.
+static int center_octant(const AABB& cell, const AABB& box) {
+    const Vertex center = cell.center();
+
+    return ((box.lower.x + box.upper.x) / 2 > center.x ? RIGHT : 0) |
+           ((box.lower.y + box.upper.y) / 2 > center.y ? TOP : 0) |
+           ((box.lower.z + box.upper.z) / 2 > center.z ? FRONT : 0);
+}
+
+// Children lie in the loose octant of their parent's cell and split that
+// octant in turn.
+static void check_loose_cells(OctreeNode* node, const AABB& cell) {
+    const std::array<OctreeNode*, 8> children = node->children();
+    for (int i = 0; i < 8; i++) {
+        if (!children[i]) continue;
+
+        REQUIRE(in_loose_octant(
+            children[i]->bounds(),
+            cell,
+            i,
+            LooseOctreePolicy::looseness
+        ));
+        check_loose_cells(children[i], helpers::octant_cell(cell, i));
+    }
+}
+
+// Every member of a node lies in the loose cell of the node: its cell for
+// the root, the loose octant of its parent's cell for children. The
+// straddlers of an inner node fit in no loose octant of its cell.
+static void check_loose_members(
+    OctreeNode* node,
+    const AABB& cell,
+    const AABB& loose,
+    const std::vector<AABB>& boxes
+) {
+    for (uint32_t id : node->members())
+        REQUIRE(box_contains(loose, boxes[id]));
+
+    if (!node->has_children()) return;
+
+    const std::span<const uint32_t> straddlers =
+        node->members().first(own_members(node));
+    for (uint32_t id : straddlers) {
+        const int octant = center_octant(cell, boxes[id]);
+        REQUIRE_FALSE(box_contains(
+            loose_octant(cell, octant, LooseOctreePolicy::looseness),
+            boxes[id]
+        ));
+    }
+
+    const std::array<OctreeNode*, 8> children = node->children();
+    for (int i = 0; i < 8; i++) {
+        if (!children[i]) continue;
+
+        check_loose_members(
+            children[i],
+            helpers::octant_cell(cell, i),
+            loose_octant(cell, i, LooseOctreePolicy::looseness),
+            boxes
+        );
+    }
+}
+
+TEST_CASE("Test loose octree", "[octree]") {
+    const std::vector<Triangle> triangles = octree_walls(3000, 23);
+    auto mesh = std::make_shared<const IndexedMesh>(triangles);
+    Octree regular(mesh);
+    Octree loose(mesh, LooseOctreePolicy());
+
+    const BuildStats& stats = loose.build();
+    REQUIRE(stats.nodes == count_nodes(&loose));
+
+    // Every triangle is stored once; the walls stay with the root.
+    size_t members = 0;
+    loose_leaf_members(&loose, members);
+    REQUIRE(members == mesh->size());
+    REQUIRE(loose.has_children());
+    REQUIRE(own_members(&loose) >= 4);
+    REQUIRE(own_members(&loose) < mesh->size());
+
+    // The walls stretch the octants of the regular root over the whole
+    // scene, the loose octants keep to their cells.
+    const AABB root = node_box(loose.bounds());
+    check_loose_cells(&loose, root);
+    check_loose_members(&loose, root, root, triangle_bounds(triangles));
+    bool stretched = false;
+    for (int i = 0; i < 8; i++) {
+        const OctreeNode* child = regular.children()[i];
+        if (child && !in_loose_octant(child->bounds(), root, i, 2))
+            stretched = true;
+    }
+    REQUIRE(stretched);
+    REQUIRE(stats.nodes != regular.build().nodes);
+
+    // Queries reach the straddlers as well as the children.
+    for (unsigned seed = 24; seed < 28; seed++) {
+        const std::vector<Triangle> other =
+            fixtures::random_soup(300, 0.1, seed);
+        Octree query(other);
+
+        const bool expected_collision = bruteforce_collides(triangles, other);
+        REQUIRE(loose.collides(&query) == expected_collision);
+        REQUIRE(query.collides(&loose) == expected_collision);
+        CollisionFront front;
+        REQUIRE(loose.collides(&query, front) == expected_collision);
+        REQUIRE(loose.collides(&query, front) == expected_collision);
+
+        size_t expected = 0;
+        regular.contacts(&query, [&](const Contact&) {
+            expected++;
+            return true;
+        });
+        size_t found = 0;
+        loose.contacts(&query, [&](const Contact&) {
+            found++;
+            return true;
+        });
+        REQUIRE(found == expected);
+
+        REQUIRE(
+            loose.distance(&query).distance ==
+            regular.distance(&query).distance
+        );
+    }
+
+    // Rays below the soup only hit the walls, which the root holds.
+    for (int i = 0; i < 20; i++) {
+        const Ray ray = {Vertex(-1, 0.5 * i, 4), Vertex(1, 0.01 * i, 0.02)};
+        REQUIRE(loose.raycast(ray).distance == regular.raycast(ray).distance);
+
+        const Ray below = {Vertex(-1, 0.5 * i, -0.9), Vertex(1, 0, 0)};
+        const RayHit hit = loose.raycast(below);
+        REQUIRE(hit.found());
+        REQUIRE(hit.triangle >= triangles.size() - 4);
+        REQUIRE(hit.distance == regular.raycast(below).distance);
+    }
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < 40; i++)
+        rays.push_back({Vertex(-1, 0.25 * i, -0.9), Vertex(1, 0, 0.001 * i)});
+    std::vector<RayHit> hits(rays.size());
+    std::vector<RayHit> expected_hits(rays.size());
+    loose.raycast(rays, hits);
+    regular.raycast(rays, expected_hits);
+    for (size_t i = 0; i < rays.size(); i++) {
+        REQUIRE(hits[i].found());
+        REQUIRE(hits[i].distance == expected_hits[i].distance);
+    }
+
+    size_t self_expected = 0;
+    regular.self_contacts([&](const Contact&) {
+        self_expected++;
+        return true;
+    });
+    size_t self_found = 0;
+    loose.self_contacts([&](const Contact&) {
+        self_found++;
+        return true;
+    });
+    REQUIRE(self_expected > 0);
+    REQUIRE(self_found == self_expected);
+
+    // Refit keeps the layout and the policy.
+    std::vector<Vertex> positions = mesh->vertices;
+    for (Vertex& vertex : positions) vertex.x *= 3;
+
+    const RefitStats refit = loose.refit(positions);
+    REQUIRE(refit.nodes == count_nodes(&loose));
+    members = 0;
+    loose_leaf_members(&loose, members);
+    REQUIRE(members == mesh->size());
+
+    // Slabs spanning the scene straddle the root and stay there, whatever
+    // their number.
+    std::vector<Triangle> slabs = octree_walls(3000, 29);
+    for (int i = 0; i < 40; i++) {
+        const double y = 0.25 * i;
+        slabs.push_back(
+            {Vertex(-1, y, -1), Vertex(11, y + 0.1, -1), Vertex(5, y, 11)}
+        );
+    }
+    Octree slabbed(slabs, LooseOctreePolicy());
+    slabbed.build();
+
+    REQUIRE(slabbed.has_children());
+    REQUIRE(own_members(&slabbed) >= 44);
+    REQUIRE(own_members(&slabbed) >= LooseOctreePolicy::leaf_size);
+
+    const AABB cell = node_box(slabbed.bounds());
+    check_loose_members(&slabbed, cell, cell, triangle_bounds(slabs));
+    members = 0;
+    loose_leaf_members(&slabbed, members);
+    REQUIRE(members == slabs.size());
+}
+
+TEST_CASE("Test octree refit follows moving vertices", "[octree]") {
+    auto mesh = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(3000, 0, 15)
+    );
+    const IndexedMesh other(fixtures::random_soup(500, 0.3, 16));
+
+    Octree tree(mesh);
+    tree.build();
+    Octree query(std::make_shared<const IndexedMesh>(other));
+
+    std::vector<Vertex> positions = mesh->vertices;
+    for (int frame = 1; frame <= 5; frame++) {
+        for (Vertex& vertex : positions) {
+            vertex.x += 0.01 * std::sin(vertex.y * 7 + frame);
+            vertex.z += 0.01 * std::cos(vertex.x * 5 + frame);
+        }
+
+        const RefitStats stats = tree.refit(positions);
+        REQUIRE_FALSE(stats.full_rebuild);
+        REQUIRE(stats.nodes == count_nodes(&tree));
+
+        IndexedMesh moved(positions, mesh->faces);
+        REQUIRE(
+            tree.collides(&query) == bruteforce_collides(moved, other)
+        );
+    }
+
+    size_t members = 0;
+    count_leaf_members(&tree, members);
+    REQUIRE(members == mesh->size());
+
+    // The mesh the tree was made from is never modified.
+    const IndexedMesh original(fixtures::random_soup(3000, 0, 15));
+    REQUIRE(mesh->vertices == original.vertices);
+
+    REQUIRE_THROWS(tree.refit({}));
+}
+
+TEST_CASE("Test octree refit rebuilds degraded subtrees", "[octree]") {
+    auto mesh = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(3000, 0, 17)
+    );
+    const IndexedMesh other(fixtures::random_soup(500, 1.5, 18));
+
+    Octree tree(mesh);
+    tree.build();
+    Octree query(std::make_shared<const IndexedMesh>(other));
+
+    // Stretching along x makes every subtree grow well past the threshold.
+    std::vector<Vertex> positions = mesh->vertices;
+    for (Vertex& vertex : positions) vertex.x *= 3;
+
+    const RefitStats stats = tree.refit(positions);
+    REQUIRE(stats.rebuilt_triangles > 0);
+    REQUIRE(stats.nodes == count_nodes(&tree));
+    REQUIRE(tree.build().nodes == stats.nodes);
+
+    IndexedMesh moved(positions, mesh->faces);
+    REQUIRE(tree.collides(&query) == bruteforce_collides(moved, other));
+
+    // Garbage left in the arena by partial rebuilds eventually triggers a
+    // full rebuild.
+    bool full_rebuild = false;
+    for (int frame = 0; frame < 4 && !full_rebuild; frame++) {
+        for (Vertex& vertex : positions) vertex.y *= 2;
+        full_rebuild = tree.refit(positions).full_rebuild;
+    }
+    REQUIRE(full_rebuild);
+}
+
+TEST_CASE("Test collision front follows moving meshes", "[octree]") {
+    auto mesh = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(2000, 0, 19)
+    );
+    Octree fixture(
+        std::make_shared<const IndexedMesh>(fixtures::random_soup(2000, 0, 20))
+    );
+
+    Octree tree(mesh);
+    CollisionFront front;
+    bool collided = false;
+    bool separated = false;
+
+    // Slide the mesh through the fixture and out again.
+    for (int frame = 0; frame <= 30; frame++) {
+        std::vector<Vertex> positions = mesh->vertices;
+        for (Vertex& vertex : positions) vertex.x += 12 - 0.8 * frame;
+        tree.refit(positions, 100);
+
+        const bool expected = tree.collides(&fixture);
+        REQUIRE(tree.collides(&fixture, front) == expected);
+        REQUIRE(tree.collides(&fixture, front) == expected);
+        collided |= expected;
+        separated |= !expected;
+    }
+    REQUIRE(collided);
+    REQUIRE(separated);
+
+    // A rebuild invalidates the front.
+    tree.reset(mesh);
+    REQUIRE(tree.collides(&fixture, front) == tree.collides(&fixture));
+}
+
+// Stack of `layers` grids, one unit apart.
+static std::vector<Triangle> octree_layers(int layers, double offset) {
+    std::vector<Triangle> triangles;
+    for (int z = 0; z < layers; z++) {
+        const std::vector<Triangle> layer =
+            fixtures::grid(20, 20, 1, z + offset).triangles();
+        triangles.insert(triangles.end(), layer.begin(), layer.end());
+    }
+
+    return triangles;
+}
+
+TEST_CASE("Test collision front skips unchanged pairs", "[octree]") {
+    // Interleaved layers: node boxes overlap everywhere, triangles never
+    // touch.
+    auto mesh = std::make_shared<const IndexedMesh>(octree_layers(8, 0));
+    Octree fixture(octree_layers(8, 0.5));
+    Octree tree(mesh);
+
+    CollisionFront front;
+    REQUIRE_FALSE(tree.collides(&fixture, front));
+    const size_t visits = front.visits();
+    REQUIRE(visits > 0);
+
+    REQUIRE_FALSE(tree.collides(&fixture, front));
+    REQUIRE(front.visits() == 0);
+
+    // Moving a handful of vertices only revisits the pairs around them.
+    std::vector<Vertex> positions = mesh->vertices;
+    for (size_t i = 0; i < 6; i++) positions[i].z += 0.1;
+    tree.refit(positions);
+
+    REQUIRE_FALSE(tree.collides(&fixture, front));
+    REQUIRE(front.visits() * 10 < visits);
+
+    // Tilting one triangle through the next layer is detected.
+    positions[0].z = 1;
+    tree.refit(positions);
+    REQUIRE(tree.collides(&fixture, front));
+    REQUIRE(tree.collides(&fixture));
+}
@@ -0,0 +1,67 @@
+#include <random>
+#include <vector>
+
+#include "../include/packs.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+TEST_CASE("Test triangle pack layout", "[packs]") {
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 11; i++)
+        triangles.push_back(
+            {Vertex(i, 0, 0), Vertex(i, 1, 0), Vertex(i, 0, 1)}
+        );
+
+    std::vector<TrianglePack> packs = pack_triangles(triangles);
+
+    REQUIRE(packs.size() == 2);
+    REQUIRE(packs[0].size == PACK_WIDTH);
+    REQUIRE(packs[1].size == 11 - PACK_WIDTH);
+
+    for (int i = 0; i < 11; i++) {
+        const TrianglePack& pack = packs[i / PACK_WIDTH];
+        REQUIRE(pack.ids[i % PACK_WIDTH] == static_cast<uint32_t>(i));
+        REQUIRE(pack.triangle(i % PACK_WIDTH) == triangles[i]);
+    }
+}
+
+TEST_CASE("Test pack candidates mask unused lanes", "[packs]") {
+    Triangle triangle{Vertex(0, 0, 0), Vertex(1, 0, 0), Vertex(0, 1, 0)};
+    std::vector<TrianglePack> packs = pack_triangles({triangle, triangle});
+
+    REQUIRE(helpers::pack_candidates(triangle, packs[0]) == 0b11);
+}
+
+TEST_CASE("Test pack kernel matches scalar kernel", "[packs]") {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-1, 1);
+    auto random_triangle = [&]() {
+        Vertex a(coordinate(generator), coordinate(generator), 0);
+        Vertex b(coordinate(generator), coordinate(generator), 0.5);
+        Vertex c(coordinate(generator), 0, coordinate(generator));
+        return Triangle{a, b, c};
+    };
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 64; i++) triangles.push_back(random_triangle());
+    std::vector<TrianglePack> packs = pack_triangles(triangles);
+
+    for (int i = 0; i < 200; i++) {
+        Triangle triangle = random_triangle();
+
+        for (const TrianglePack& pack : packs) {
+            uint32_t expected = 0;
+            for (uint32_t lane = 0; lane < pack.size; lane++)
+                if (helpers::triangles_intersect(triangle, pack.triangle(lane)))
+                    expected |= 1u << lane;
+
+            const uint32_t candidates =
+                helpers::pack_candidates(triangle, pack);
+            REQUIRE((candidates & expected) == expected);
+            REQUIRE(
+                helpers::pack_intersects(triangle, pack) == (expected != 0)
+            );
+        }
+    }
+}
@@ -0,0 +1,220 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "../include/packs.hpp"
+#include "../include/ray.hpp"
+#include "../include/scheduler.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static std::vector<Ray> random_rays(int count, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coordinate(-2, 12);
+    std::uniform_real_distribution<double> direction(-1, 1);
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < count; i++)
+        rays.push_back(
+            {Vertex(
+                 coordinate(generator),
+                 coordinate(generator),
+                 coordinate(generator)
+             ),
+             Vertex(
+                 direction(generator),
+                 direction(generator),
+                 direction(generator)
+             )}
+        );
+
+    return rays;
+}
+
+static RayHit bruteforce_raycast(
+    const IndexedMesh& mesh,
+    const Ray& ray,
+    double tmax
+) {
+    RayHit hit;
+    hit.distance = tmax;
+    for (uint32_t i = 0; i < mesh.size(); i++)
+        helpers::ray_triangle(ray, mesh.triangle(i), i, hit);
+
+    return hit.found() ? hit : RayHit();
+}
+
+TEST_CASE("Test ray triangle kernels", "[ray]") {
+    const Triangle floor = {Vertex(0, 0, 0), Vertex(4, 0, 0), Vertex(0, 4, 0)};
+    const Ray down = {Vertex(1, 2, 5), Vertex(0, 0, -2)};
+
+    RayHit hit;
+    REQUIRE(helpers::ray_triangle(down, floor, 7, hit));
+    REQUIRE(hit.triangle == 7);
+    REQUIRE(hit.distance == 2.5);
+    REQUIRE(hit.u == 0.25);
+    REQUIRE(hit.v == 0.5);
+
+    // Closer hits only, and never behind the origin or beside the triangle.
+    REQUIRE_FALSE(helpers::ray_triangle(down, floor, 8, hit));
+    RayHit miss;
+    REQUIRE_FALSE(helpers::ray_triangle(
+        {Vertex(1, 2, -5), Vertex(0, 0, -2)},
+        floor,
+        0,
+        miss
+    ));
+    REQUIRE_FALSE(helpers::ray_triangle(
+        {Vertex(3, 3, 5), Vertex(0, 0, -2)},
+        floor,
+        0,
+        miss
+    ));
+    REQUIRE_FALSE(helpers::ray_triangle(
+        {Vertex(1, 1, 1), Vertex(1, 0, 0)},
+        floor,
+        0,
+        miss
+    ));
+    REQUIRE_FALSE(miss.found());
+
+    // The packed kernel finds the same hits as the scalar one.
+    const IndexedMesh mesh(fixtures::random_soup(PACK_WIDTH - 3, 0, 11));
+    std::vector<uint32_t> indices(mesh.size());
+    for (uint32_t i = 0; i < mesh.size(); i++) indices[i] = i;
+    TrianglePack pack;
+    pack_triangles(&pack, mesh, indices.data(), indices.size());
+
+    for (const Ray& ray : random_rays(2000, 12)) {
+        const RayHit expected = bruteforce_raycast(mesh, ray, 100);
+        RayHit packed;
+        packed.distance = 100;
+
+        REQUIRE(helpers::pack_raycast(ray, pack, packed) == expected.found());
+        if (expected.found()) {
+            REQUIRE(packed.triangle == expected.triangle);
+            REQUIRE(packed.distance == expected.distance);
+        }
+    }
+}
+
+TEST_CASE("Test ray box slab tests", "[ray]") {
+    const BoundingBox box(Vertex(1, 1, 1), Vertex(2, 2, 2), 0);
+    const Ray ray = {Vertex(0, 1.5, 1.5), Vertex(1, 0, 0)};
+    const Vertex inverse = helpers::ray_inverse(ray);
+
+    double entry;
+    REQUIRE(helpers::ray_box(ray, inverse, box, 10, entry));
+    REQUIRE(entry == 1);
+    REQUIRE_FALSE(helpers::ray_box(ray, inverse, box, 0.5, entry));
+
+    // A ray along a face of the box still meets it.
+    const Ray grazing = {Vertex(0, 1, 1.5), Vertex(1, 0, 0)};
+    REQUIRE(helpers::ray_box(
+        grazing,
+        helpers::ray_inverse(grazing),
+        box,
+        10,
+        entry
+    ));
+
+    std::array<const BoundingBox*, 8> boxes = {nullptr};
+    const BoundingBox behind(Vertex(-3, 1, 1), Vertex(-2, 2, 2), 0);
+    const BoundingBox beside(Vertex(3, 3, 1), Vertex(4, 4, 2), 0);
+    boxes[0] = &box;
+    boxes[2] = &behind;
+    boxes[5] = &beside;
+    double entries[8];
+    REQUIRE(
+        helpers::ray_boxes(ray, inverse, BoxPack(boxes), 10, entries) == 0b1
+    );
+    REQUIRE(entries[0] == 1);
+
+    const std::vector<Ray> rays = {
+        ray,
+        {Vertex(0, 1.5, 1.5), Vertex(-1, 0, 0)},
+        {Vertex(1.5, 1.5, 1.5), Vertex(0, 1, 0)},
+        {Vertex(10, 1.5, 1.5), Vertex(-1, 0, 0)}
+    };
+    REQUIRE(helpers::packet_box(RayPacket(rays, 5), box) == 0b0101);
+}
+
+TEST_CASE("Test octree raycast", "[ray]") {
+    auto mesh = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(3000, 0, 21)
+    );
+    Octree octree(mesh);
+    const std::vector<Ray> rays = random_rays(500, 22);
+
+    size_t found = 0;
+    for (const Ray& ray : rays) {
+        for (double tmax : {3.0, std::numeric_limits<double>::infinity()}) {
+            const RayHit expected = bruteforce_raycast(*mesh, ray, tmax);
+            const RayHit hit = octree.raycast(ray, tmax);
+
+            REQUIRE(hit.found() == expected.found());
+            REQUIRE(octree.occluded(ray, tmax) == expected.found());
+            if (!expected.found()) continue;
+
+            found++;
+            REQUIRE(hit.triangle == expected.triangle);
+            REQUIRE(hit.distance == expected.distance);
+            REQUIRE(hit.u == expected.u);
+            REQUIRE(hit.v == expected.v);
+        }
+    }
+    REQUIRE(found > 100);
+
+    // A segment is the ray cut at 1.
+    const Triangle wall = mesh->triangle(0);
+    const Vertex target(
+        (wall[0].x + wall[1].x + wall[2].x) / 3,
+        (wall[0].y + wall[1].y + wall[2].y) / 3,
+        (wall[0].z + wall[1].z + wall[2].z) / 3
+    );
+    const Ray segment = {
+        Vertex(target.x - 20, target.y, target.z),
+        Vertex(20, 0, 0)
+    };
+    REQUIRE(octree.occluded(segment, 1.01));
+    REQUIRE(octree.raycast(segment, 1.01).distance <= 1 + 1e-12);
+}
+
+TEST_CASE("Test octree ray packets", "[ray]") {
+    auto mesh = std::make_shared<const IndexedMesh>(
+        fixtures::random_soup(3000, 0, 31)
+    );
+    Octree octree(mesh);
+
+    // Not a multiple of the packet width, so that the last packet is short.
+    const std::vector<Ray> rays = random_rays(1003, 32);
+    std::vector<RayHit> expected(rays.size());
+    for (size_t i = 0; i < rays.size(); i++)
+        expected[i] = octree.raycast(rays[i], 8);
+
+    std::vector<RayHit> hits(rays.size());
+    octree.raycast(rays, hits, 8);
+    TaskPool pool(4);
+    std::vector<RayHit> parallel(rays.size());
+    octree.raycast(rays, parallel, 8, &pool);
+
+    for (size_t i = 0; i < rays.size(); i++) {
+        REQUIRE(hits[i].triangle == expected[i].triangle);
+        REQUIRE(hits[i].distance == expected[i].distance);
+        REQUIRE(parallel[i].triangle == expected[i].triangle);
+    }
+
+    std::vector<RayHit> short_hits(3);
+    REQUIRE_THROWS_AS(
+        octree.raycast(rays, short_hits),
+        std::invalid_argument
+    );
+}
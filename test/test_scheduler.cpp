@@ -0,0 +1,104 @@
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/octree.hpp"
+#include "../include/scheduler.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static double scheduler_wave(int i, int j) {
+    return std::sin(i * j) / 4;
+}
+
+TEST_CASE("Test task pool runs nested tasks", "[scheduler]") {
+    TaskPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    for (int round = 0; round < 3; round++) {
+        std::atomic<int> count = 0;
+        TaskGroup group;
+
+        std::function<void(int)> spawn = [&](int depth) {
+            count++;
+            if (depth == 0) return;
+            for (int i = 0; i < 4; i++)
+                pool.submit(group, [&spawn, depth]() {
+                    spawn(depth - 1);
+                });
+        };
+
+        pool.submit(group, [&spawn]() {
+            spawn(5);
+        });
+        pool.wait(group);
+
+        REQUIRE(group.done());
+        REQUIRE(count == (1 + 4 + 16 + 64 + 256 + 1024));
+    }
+}
+
+TEST_CASE("Test task pool without workers", "[scheduler]") {
+    TaskPool pool(0);
+    TaskGroup group;
+    int count = 0;
+
+    for (int i = 0; i < 10; i++)
+        pool.submit(group, [&count]() {
+            count++;
+        });
+    pool.wait(group);
+
+    REQUIRE(count == 10);
+}
+
+TEST_CASE("Test task pool rethrows task errors", "[scheduler]") {
+    for (size_t threads : {0, 4}) {
+        TaskPool pool(threads);
+        TaskGroup group;
+        std::atomic<int> count = 0;
+
+        for (int i = 0; i < 100; i++)
+            pool.submit(group, [&count, i]() {
+                count++;
+                if (i % 10 == 3) throw std::runtime_error("task failed");
+            });
+        REQUIRE_THROWS_AS(pool.wait(group), std::runtime_error);
+        REQUIRE(group.done());
+        REQUIRE(count == 100);
+
+        // The error was handed out, the group can be waited for again.
+        pool.submit(group, [&count]() {
+            count++;
+        });
+        pool.wait(group);
+        REQUIRE(count == 101);
+    }
+}
+
+TEST_CASE("Test parallel octree collision", "[scheduler]") {
+    TaskPool pool(4);
+    std::vector<Triangle> grid =
+        fixtures::grid(40, 40, 1, 0, scheduler_wave).triangles();
+
+    for (double height : {-0.5, 0.05, 0.2, 3.0}) {
+        std::vector<Triangle> other =
+            fixtures::grid(40, 40, 1, height, scheduler_wave).triangles();
+        for (Triangle& triangle : other)
+            for (Vertex& vertex : triangle)
+                vertex = Vertex(vertex.x + 0.4, vertex.y + 0.3, vertex.z);
+
+        Octree tree1(grid);
+        Octree tree2(other);
+        Octree parallel1(grid);
+        Octree parallel2(other);
+
+        REQUIRE(
+            parallel1.collides(&parallel2, pool) == tree1.collides(&tree2)
+        );
+    }
+}
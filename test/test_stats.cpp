@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../include/hashmap.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "../include/stats.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static std::vector<Triangle> stats_shifted(
+    const std::vector<Triangle>& triangles,
+    double shift
+) {
+    std::vector<Triangle> shifted;
+    for (const Triangle& triangle : triangles) {
+        Triangle moved = triangle;
+        for (Vertex& vertex : moved)
+            vertex = Vertex(vertex.x + shift, vertex.y + shift, vertex.z);
+        shifted.push_back(moved);
+    }
+
+    return shifted;
+}
+
+TEST_CASE("Test octree query stats", "[stats]") {
+    SECTION("Separated trees") {
+        Octree tree1(fixtures::random_soup(200, 0, 11));
+        Octree tree2(fixtures::random_soup(200, 12, 12));
+
+        QueryStats stats;
+        REQUIRE_FALSE(tree1.collides(&tree2, stats));
+        REQUIRE(stats.visited_pairs == 1);
+        REQUIRE(stats.pruned_pairs == 1);
+        REQUIRE(stats.box_tests == 1);
+        REQUIRE(stats.leaf_tests == 0);
+        REQUIRE(stats.triangle_tests == 0);
+        REQUIRE(stats.leaf_ns == 0);
+        REQUIRE(stats.build_ns > 0);
+    }
+
+    SECTION("Same outcome as the regular query") {
+        for (unsigned seed = 0; seed < 8; seed++) {
+            const int count = 50 + 100 * seed;
+            Octree tree1(fixtures::random_soup(count, 0, seed));
+            Octree tree2(fixtures::random_soup(count, 5, seed + 100));
+
+            QueryStats stats;
+            REQUIRE(tree1.collides(&tree2, stats) == tree1.collides(&tree2));
+            REQUIRE(stats.visited_pairs >= stats.leaf_tests);
+            REQUIRE(stats.box_tests >= stats.visited_pairs);
+            REQUIRE(stats.leaf_tests > 0);
+            REQUIRE(stats.triangle_tests > 0);
+            REQUIRE(
+                stats.triangle_tests <= static_cast<uint64_t>(count) * count
+            );
+        }
+    }
+
+    SECTION("Stats add up") {
+        Octree tree1(fixtures::random_soup(400, 0, 21));
+        Octree tree2(fixtures::random_soup(400, 3, 22));
+        tree1.build();
+        tree2.build();
+
+        QueryStats once;
+        QueryStats twice;
+        tree1.collides(&tree2, once);
+        tree1.collides(&tree2, twice);
+        tree1.collides(&tree2, twice);
+
+        REQUIRE(twice.visited_pairs == 2 * once.visited_pairs);
+        REQUIRE(twice.pruned_pairs == 2 * once.pruned_pairs);
+        REQUIRE(twice.box_tests == 2 * once.box_tests);
+        REQUIRE(twice.leaf_tests == 2 * once.leaf_tests);
+        REQUIRE(twice.triangle_tests == 2 * once.triangle_tests);
+
+        QueryStats sum = once;
+        sum += once;
+        REQUIRE(sum.triangle_tests == twice.triangle_tests);
+        REQUIRE(sum.total_ns() == 2 * once.total_ns());
+    }
+}
+
+TEST_CASE("Test hashmap query stats", "[stats]") {
+    // Each triangle is close to its shifted copy but parallel to it, so the
+    // query finds no collision and tests every candidate pair.
+    const std::vector<Triangle> triangles = fixtures::random_soup(60, 0, 31);
+    const std::vector<Triangle> shifted = stats_shifted(triangles, 0.05);
+    const IndexedMesh mesh(shifted);
+    const SpatialHashMap map(triangles, 3);
+
+    QueryStats stats;
+    REQUIRE(map.collides(mesh, stats) == map.collides(mesh));
+    REQUIRE_FALSE(map.collides(mesh));
+
+    uint64_t overlapping = 0;
+    for (const Triangle& stored : triangles)
+        for (const Triangle& queried : shifted)
+            if (AABB(stored).overlaps(AABB(queried))) overlapping++;
+
+    REQUIRE(overlapping > 0);
+    REQUIRE(stats.triangle_tests == overlapping);
+    REQUIRE(stats.visited_pairs - stats.pruned_pairs == overlapping);
+    REQUIRE(stats.box_tests == stats.visited_pairs);
+    REQUIRE(stats.leaf_tests > 0);
+    REQUIRE(stats.build_ns == 0);
+}
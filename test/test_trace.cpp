@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/octree.hpp"
+#include "../include/trace.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static size_t trace_count(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos;
+         at = text.find(pattern, at + 1))
+        count++;
+
+    return count;
+}
+
+static std::string trace_dump() {
+    std::ostringstream out;
+    trace::write_chrome_json(out);
+    return out.str();
+}
+
+TEST_CASE("Test trace spans", "[trace]") {
+    trace::clear();
+
+    {
+        const trace::Span outer("test.outer");
+        const trace::Span inner("test.inner");
+    }
+
+    const std::string json = trace_dump();
+    REQUIRE(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    REQUIRE(json.ends_with("]}\n"));
+    REQUIRE(trace_count(json, "\"name\":\"test.outer\"") == 1);
+    REQUIRE(trace_count(json, "\"name\":\"test.inner\"") == 1);
+    REQUIRE(trace_count(json, "\"ph\":\"X\"") == 2);
+
+    // Inner spans end first.
+    REQUIRE(json.find("test.inner") < json.find("test.outer"));
+
+    trace::clear();
+    REQUIRE(trace_count(trace_dump(), "\"ph\":\"X\"") == 0);
+}
+
+TEST_CASE("Test trace buffers", "[trace]") {
+    trace::clear();
+
+    SECTION("The oldest spans are overwritten") {
+        const uint64_t start = trace::now();
+        trace::record("test.first", start, start + 1);
+        for (size_t i = 0; i < TRACE_BUFFER_SIZE; i++)
+            trace::record("test.span", start, start + 1);
+
+        const std::string json = trace_dump();
+        REQUIRE(trace_count(json, "test.first") == 0);
+        REQUIRE(trace_count(json, "test.span") == TRACE_BUFFER_SIZE);
+    }
+
+    SECTION("One track per thread") {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 3; i++)
+            threads.emplace_back([]() {
+                const trace::Span span("test.thread");
+            });
+        for (std::thread& thread : threads) thread.join();
+
+        // Buffers outlive their thread.
+        const std::string json = trace_dump();
+        REQUIRE(trace_count(json, "test.thread") == 3);
+    }
+
+    SECTION("Dumps and clears while a thread records") {
+        std::atomic<bool> done = false;
+        std::thread recorder([&done]() {
+            while (!done.load()) const trace::Span span("test.busy");
+        });
+
+        for (int i = 0; i < 20; i++) {
+            const std::string json = trace_dump();
+            REQUIRE(json.ends_with("]}\n"));
+            REQUIRE(
+                trace_count(json, "\"ph\":\"X\"") ==
+                trace_count(json, "\"name\":\"test.busy\"")
+            );
+            trace::clear();
+        }
+
+        done.store(true);
+        recorder.join();
+    }
+
+    trace::clear();
+}
+
+TEST_CASE("Test traced queries", "[trace]") {
+    trace::clear();
+
+    Octree tree1({{Vertex(0, 0, 0), Vertex(1, 0, 0), Vertex(0, 1, 0)}});
+    Octree tree2({{Vertex(0, 0, -1), Vertex(0, 0, 1), Vertex(1, 1, 0)}});
+    REQUIRE(tree1.collides(&tree2));
+
+    // Library spans are only compiled in with tracing enabled.
+    const std::string json = trace_dump();
+    const size_t expected = trace::ENABLED ? 1 : 0;
+    REQUIRE(trace_count(json, "\"Octree::collides\"") == expected);
+    REQUIRE(trace_count(json, "\"Octree::build\"") == 2 * expected);
+    REQUIRE(trace_count(json, "\"Octree::leaf_test\"") == expected);
+
+    trace::clear();
+}
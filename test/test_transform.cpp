@@ -0,0 +1,133 @@
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "../include/common.hpp"
+#include "../include/mesh.hpp"
+#include "../include/octree.hpp"
+#include "../include/transform.hpp"
+#include "./fixtures.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+using namespace YAAACD;
+
+static bool close(const Vertex& lhs, const Vertex& rhs) {
+    return std::abs(lhs.x - rhs.x) < 1e-9 && std::abs(lhs.y - rhs.y) < 1e-9 &&
+           std::abs(lhs.z - rhs.z) < 1e-9;
+}
+
+// Shared soup scaled down into [-1, 1]^3, around the pivot of the poses.
+static std::vector<Triangle> transform_soup(int count, unsigned seed) {
+    std::vector<Triangle> triangles = fixtures::random_soup(count, 0, seed);
+    for (Triangle& triangle : triangles)
+        for (Vertex& vertex : triangle)
+            vertex = Vertex(
+                vertex.x / 5 - 1,
+                vertex.y / 5 - 1,
+                vertex.z / 5 - 1
+            );
+
+    return triangles;
+}
+
+TEST_CASE("Test transform inverse and composition", "[transform]") {
+    const Transform first =
+        Transform::rotation_about(Vertex(1, 2, 3), 0.7, Vertex(1, -2, 0.5));
+    const Transform second =
+        Transform::rotation_about(Vertex(0, 0, 1), -1.3, Vertex(0, 4, 0));
+    const Vertex vertex(0.3, -0.8, 2);
+
+    REQUIRE(close(first.inverse().apply(first.apply(vertex)), vertex));
+    REQUIRE(close(
+        (second * first).apply(vertex),
+        second.apply(first.apply(vertex))
+    ));
+
+    const Transform quarter =
+        Transform::rotation_about(Vertex(0, 0, 1), std::numbers::pi / 2);
+    REQUIRE(close(quarter.apply(Vertex(1, 0, 0)), Vertex(0, 1, 0)));
+}
+
+TEST_CASE("Test oriented box overlap", "[transform]") {
+    const BoundingBox box(Vertex(0, 0, 0), Vertex(1, 1, 1), 0);
+
+    // The corner of a cube turned by 45 degrees reaches sqrt(2)/2 from its
+    // center.
+    const Transform turned =
+        Transform::rotation_about(Vertex(0, 0, 1), std::numbers::pi / 4);
+    const BoundingBox centered(Vertex(-0.5, -0.5, 0), Vertex(0.5, 0.5, 1), 0);
+
+    Transform near = turned;
+    near.translation = Vertex(1.65, 0.5, 0);
+    REQUIRE(helpers::boxes_overlap(box, centered, near));
+
+    Transform far = turned;
+    far.translation = Vertex(1.75, 0.5, 0);
+    REQUIRE_FALSE(helpers::boxes_overlap(box, centered, far));
+
+    // Never separated when a point of the moved box lies in the first one.
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::uniform_real_distribution<double> fraction(-0.5, 0.5);
+    for (int i = 0; i < 200; i++) {
+        const Transform transform = Transform::rotation_about(
+            Vertex(unit(generator), unit(generator), unit(generator)),
+            3 * unit(generator),
+            Vertex(
+                0.5 + 1.5 * unit(generator),
+                0.5 + 1.5 * unit(generator),
+                0.5 + 1.5 * unit(generator)
+            )
+        );
+
+        bool inside = false;
+        for (int j = 0; j < 50 && !inside; j++)
+            inside = box.contains(transform.apply(Vertex(
+                fraction(generator),
+                fraction(generator),
+                0.5 + fraction(generator)
+            )));
+
+        if (inside) REQUIRE(helpers::boxes_overlap(box, centered, transform));
+    }
+}
+
+TEST_CASE("Test octree collision under rigid transforms", "[transform]") {
+    auto fixture = std::make_shared<const IndexedMesh>(transform_soup(600, 1));
+    auto link = std::make_shared<const IndexedMesh>(transform_soup(300, 2));
+
+    Octree fixture_tree(fixture);
+    Octree link_tree(link);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::uniform_real_distribution<double> angle(0, 2 * std::numbers::pi);
+
+    for (int pose = 0; pose < 40; pose++) {
+        const Transform transform = Transform::rotation_about(
+            Vertex(unit(generator), unit(generator), unit(generator)),
+            angle(generator),
+            Vertex(
+                1.5 * unit(generator),
+                1.5 * unit(generator),
+                1.5 * unit(generator)
+            )
+        );
+
+        std::vector<Triangle> moved;
+        for (uint32_t i = 0; i < link->size(); i++)
+            moved.push_back(transform.apply(link->triangle(i)));
+
+        REQUIRE(
+            fixture_tree.collides(&link_tree, transform) ==
+            bruteforce_collides(fixture->triangles(), moved)
+        );
+    }
+
+    REQUIRE(
+        fixture_tree.collides(&link_tree, Transform()) ==
+        fixture_tree.collides(&link_tree)
+    );
+}